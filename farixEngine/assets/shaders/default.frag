@@ -5,19 +5,28 @@ out vec4 FragColor;
 in vec2 texCoord;
 in vec3 Normal;
 in vec3 crntPos;
+in vec4 vertexColor;
 
 uniform sampler2D tex0;
-uniform vec4 objectColor;
-uniform bool useTexture;
-uniform vec4 lightColor;
-uniform vec3 lightPos;
-uniform vec3 camPos;
-uniform bool enableLight;
-
-uniform float matAmbient;   
-uniform float matDiffuse;   
-uniform float matSpecular;  
-uniform float matShininess;  
+
+layout (std140, binding = 0) uniform PassBlock
+{
+	mat4 camMatrix;
+	vec4 lightColor;
+	vec3 lightPos;
+	vec3 camPos;
+	bool enableLight;
+};
+
+layout (std140, binding = 1) uniform MaterialBlock
+{
+	float matAmbient;
+	float matDiffuse;
+	float matSpecular;
+	float matShininess;
+	bool useTexture;
+};
+
 vec4 pointLight()
 {
 
@@ -42,7 +51,7 @@ vec4 pointLight()
   if(useTexture){
       return  texture(tex0, texCoord) * lightColor * (diffuse * inten + ambient + specular);
   } else {
-    return objectColor *  lightColor * (diffuse * inten + ambient + specular);
+    return vertexColor *  lightColor * (diffuse * inten + ambient + specular);
 
   }
   
@@ -63,7 +72,7 @@ vec4 directLight()
     float spec = pow(max(dot(viewDir, reflectDir), 0.0), matShininess);
     
 
-    vec4 baseColor = useTexture ? texture(tex0, texCoord) : objectColor;
+    vec4 baseColor = useTexture ? texture(tex0, texCoord) : vertexColor;
     
     vec3 ambientTerm  = matAmbient * lightColor.rgb;
     vec3 diffuseTerm  = diffuse * matDiffuse * baseColor.rgb * lightColor.rgb;
@@ -101,7 +110,7 @@ vec4 spotLight()
 
     return  texture(tex0, texCoord) * lightColor * (diffuse * inten + ambient + specular*inten);
   } else{
-    return objectColor * lightColor * (diffuse * inten + ambient + specular*inten);
+    return vertexColor * lightColor * (diffuse * inten + ambient + specular*inten);
   }
 }
 
@@ -114,7 +123,7 @@ if(enableLight){
 
 
 } else{
-  FragColor= useTexture ? texture(tex0, texCoord) : objectColor;
+  FragColor= useTexture ? texture(tex0, texCoord) : vertexColor;
 
 }
 
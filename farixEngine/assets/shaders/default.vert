@@ -3,18 +3,33 @@
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNormal;
 layout (location = 2) in vec2 aTex;
+layout (location = 3) in mat4 aInstanceModel;
+layout (location = 7) in vec4 aInstanceColor;
 
 out vec2 texCoord;
 out vec3 Normal;
 out vec3 crntPos;
+out vec4 vertexColor;
+
+layout (std140, binding = 0) uniform PassBlock
+{
+	mat4 camMatrix;
+	vec4 lightColor;
+	vec3 lightPos;
+	vec3 camPos;
+	bool enableLight;
+};
 
-uniform mat4 camMatrix;
 uniform mat4 model;
+uniform vec4 objectColor;
+uniform bool instanced;
 
 
 void main()
 {
-	crntPos = vec3(model * vec4(aPos, 1.0f));
+	mat4 world = instanced ? aInstanceModel : model;
+	vertexColor = instanced ? aInstanceColor : objectColor;
+	crntPos = vec3(world * vec4(aPos, 1.0f));
 	gl_Position = camMatrix * vec4(crntPos, 1.0);
 
 	texCoord = aTex;
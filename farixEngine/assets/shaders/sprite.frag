@@ -0,0 +1,14 @@
+#version 460 core
+
+out vec4 FragColor;
+
+in vec2 texCoord;
+in vec4 vertexColor;
+
+uniform sampler2D tex0;
+uniform bool useTexture;
+
+void main()
+{
+	FragColor = useTexture ? texture(tex0, texCoord) * vertexColor : vertexColor;
+}
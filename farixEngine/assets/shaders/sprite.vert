@@ -0,0 +1,24 @@
+#version 460 core
+
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec2 aTex;
+layout (location = 2) in vec4 aColor;
+
+out vec2 texCoord;
+out vec4 vertexColor;
+
+layout (std140, binding = 0) uniform PassBlock
+{
+	mat4 camMatrix;
+	vec4 lightColor;
+	vec3 lightPos;
+	vec3 camPos;
+	bool enableLight;
+};
+
+void main()
+{
+	gl_Position = camMatrix * vec4(aPos, 1.0);
+	texCoord = aTex;
+	vertexColor = aColor;
+}
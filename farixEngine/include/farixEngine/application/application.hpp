@@ -9,7 +9,8 @@ public:
 
   virtual void onUpdate(float dt) = 0;
   virtual void onStart() = 0;
-  void run(int width, int height, const char *title);
+  void run(int width, int height, const char *title,
+           RendererBackend backend = RendererBackend::OpenGL);
   SceneManager &getSceneManager();
 
 protected:
@@ -1,4 +1,6 @@
 #pragma once
+#include <cstdint>
+#include <functional>
 #include <memory>
 #include <optional>
 #include <stdexcept>
@@ -9,10 +11,17 @@
 
 namespace farixEngine {
 
-class Asset {
+class Asset : public std::enable_shared_from_this<Asset> {
 public:
   std::string id = "";
   std::string name = "";
+  // Bumped by markChanged(); caches built from the asset compare it to
+  // decide whether to rebuild.
+  uint32_t version = 0;
+
+  // Call after editing the asset in place. Assets with derived data rebuild
+  // it here.
+  virtual void markChanged() { ++version; }
 
   virtual ~Asset() = default;
 };
@@ -23,10 +32,17 @@ class AssetManager {
   using AssetMap = std::unordered_map<std::string, std::shared_ptr<T>>;
 
 public:
+  using ListenerID = uint64_t;
+  using RemovalListener = std::function<void(const AssetID &id)>;
+
   template <typename T>
   AssetID add(std::shared_ptr<T> asset, const std::string &name = "") {
     UUID id = asset->id;
+    // Replacing an asset invalidates whatever was derived from the old one.
+    if (allAssetsRaw.count(id))
+      notifyRemoved(id);
     getAssetMap<T>()[id] = asset;
+    eraseTyped[id] = [this, id]() { getAssetMap<T>().erase(id); };
     allAssetsRaw[id] = asset;
     if (!name.empty()) {
       nameToUUIDMap[name] = id;
@@ -52,6 +68,15 @@ public:
     return add<T>(asset, name);
   }
 
+  // Drops the asset and its name. Removal listeners run first, while the
+  // asset is still registered.
+  bool remove(const std::string &idOrName);
+
+  // Called with the id of every asset that is removed or replaced, so caches
+  // built from it can be dropped.
+  ListenerID onAssetRemoved(RemovalListener callback);
+  void removeListener(ListenerID id);
+
   template <typename T> std::shared_ptr<T> get(const UUID &idOrName) {
     auto &assets = getAssetMap<T>();
 
@@ -131,6 +156,8 @@ public:
   }
 
 private:
+  void notifyRemoved(const AssetID &id);
+
   template <typename T> AssetMap<T> &getAssetMap() {
     static AssetMap<T> assetMap;
     return assetMap;
@@ -143,6 +170,10 @@ private:
   std::unordered_map<std::string, std::string> nameToUUIDMap;
   std::unordered_map<std::string, std::string> uuidToNameMap;
   std::unordered_map<AssetID, std::shared_ptr<Asset>> allAssetsRaw;
+  // Erases an id from the typed map it was added to.
+  std::unordered_map<AssetID, std::function<void()>> eraseTyped;
+  ListenerID nextListenerID = 1;
+  std::unordered_map<ListenerID, RemovalListener> removalListeners;
 };
 
 } // namespace farixEngine
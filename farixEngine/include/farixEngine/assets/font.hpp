@@ -1,6 +1,7 @@
 #pragma once
 #include "farixEngine/utils/uuid.hpp"
 #include "farixEngine/assets/assetManager.hpp"
+#include "farixEngine/assets/glyphAtlas.hpp"
 #include <SDL_ttf.h>
 #include <iostream>
 #include <memory>
@@ -10,7 +11,14 @@ struct Font : public Asset {
   std::string path="";
   std::string id ="";
   int ptsize;
-  
+  // Built on first use by text renderers.
+  std::unique_ptr<GlyphAtlas> atlas;
+
+  GlyphAtlas &glyphAtlas() {
+    if (!atlas)
+      atlas = std::make_unique<GlyphAtlas>(sdlFont);
+    return *atlas;
+  }
 
   ~Font() {
     if (sdlFont)
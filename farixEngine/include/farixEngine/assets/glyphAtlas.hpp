@@ -0,0 +1,78 @@
+#pragma once
+
+#include "farixEngine/math/vec2.hpp"
+#include <SDL_ttf.h>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace farixEngine {
+
+// Placement of one glyph bitmap in the atlas, in pixels. offsetX/offsetY
+// place the bitmap relative to the pen position and the top of the line.
+struct Glyph {
+  int atlasX = 0;
+  int atlasY = 0;
+  int width = 0;
+  int height = 0;
+  int offsetX = 0;
+  int offsetY = 0;
+  int advance = 0;
+};
+
+// One glyph of laid out text in line units: a line is 1 high, y points up
+// and the text block is centered on the origin. uvMin belongs to the min
+// corner.
+struct GlyphQuad {
+  Vec2 min;
+  Vec2 max;
+  Vec2 uvMin;
+  Vec2 uvMax;
+};
+
+// Glyphs of one font size packed into a single RGBA texture, white with the
+// coverage in alpha, so one atlas serves every text color. Printable ASCII
+// is packed up front; other code points are rasterized on first use and
+// fall back to '?' once the atlas is full.
+class GlyphAtlas {
+public:
+  explicit GlyphAtlas(TTF_Font *font);
+
+  const Glyph *glyph(uint32_t codepoint);
+
+  // Appends one quad per visible glyph of the UTF-8 text; '\n' starts a new
+  // line. Returns the size of the text block in line units.
+  Vec2 layout(const std::string &text, std::vector<GlyphQuad> &out);
+
+  const std::vector<uint8_t> &pixels() const { return atlasPixels; }
+  int width() const { return atlasWidth; }
+  int height() const { return atlasHeight; }
+  int lineHeight() const { return fontHeight; }
+  // Bumped whenever glyphs are added, so GPU copies know to refresh.
+  uint32_t version() const { return atlasVersion; }
+
+private:
+  static constexpr int kPadding = 1;
+
+  bool pack(uint32_t codepoint, Glyph &glyph);
+
+  TTF_Font *font = nullptr;
+  int fontHeight = 1;
+  int atlasWidth = 0;
+  int atlasHeight = 0;
+  std::vector<uint8_t> atlasPixels;
+  uint32_t atlasVersion = 0;
+
+  // Shelf packer state.
+  int shelfX = 0;
+  int shelfY = 0;
+  int shelfHeight = 0;
+  bool full = false;
+
+  Glyph ascii[128];
+  bool asciiPacked[128] = {};
+  std::unordered_map<uint32_t, Glyph> extended;
+};
+
+} // namespace farixEngine
@@ -9,6 +9,8 @@
 
 namespace farixEngine {
 
+enum class BlendMode { Opaque, Alpha, Additive };
+
 struct Material : public Asset {
   std::string id;
   std::string path;
@@ -22,6 +24,7 @@ struct Material : public Asset {
 
   bool useTexture = false;
   bool doubleSided = true;
+  BlendMode blendMode = BlendMode::Alpha;
 
   Material(UUID uuid = "") : id(uuid.empty() ? utils::generateUUID() : uuid) {}
 };
@@ -1,4 +1,5 @@
 #pragma once
+#include "farixEngine/math/bounds.hpp"
 #include "farixEngine/math/vec2.hpp"
 #include "farixEngine/math/vec3.hpp"
 #include "farixEngine/assets/assetManager.hpp"
@@ -24,9 +25,24 @@ struct Vertex {
   }
 };
 
-struct Mesh : public Asset {
+// Geometry in the layout every renderer consumes directly. Never modified
+// once published: MeshData and GPU uploads share it by handle, and new
+// geometry replaces the whole buffer.
+struct MeshBuffer {
   std::vector<Vertex> vertices;
   std::vector<uint32_t> indices;
+};
+using MeshBufferHandle = std::shared_ptr<const MeshBuffer>;
+
+// A coarser version of a mesh, drawn once the mesh's bounding sphere covers
+// less than screenSize of the viewport height.
+struct MeshLod {
+  MeshBufferHandle buffer;
+  float screenSize = 0.0f;
+};
+
+struct Mesh : public Asset {
+  MeshBufferHandle buffer = std::make_shared<MeshBuffer>();
   std::string path="";
   std::string type="";
   std::string id="";
@@ -34,6 +50,26 @@ struct Mesh : public Asset {
   Vec3 size{1};
   Vec3 sphereData{1.0, 16.0, 32.0};
 
+  // Model-space bounds, filled by the factories below.
+  AABB bounds;
+  BoundingSphere boundingSphere;
+  void computeBounds();
+
+  // Coarser levels of detail, finest first; empty for meshes too small to
+  // be worth simplifying.
+  std::vector<MeshLod> lods;
+  // Rebuilds lods by halving the triangle count per level with
+  // simplifyMesh, stopping early once a level no longer shrinks much.
+  void generateLods(size_t maxLevels = 3);
+
+  const std::vector<Vertex> &vertices() const { return buffer->vertices; }
+  const std::vector<uint32_t> &indices() const { return buffer->indices; }
+  // Publishes new geometry, recomputes the bounds, drops the now stale lods
+  // and marks the mesh changed. Renderers still drawing the old buffer keep
+  // it alive.
+  void setGeometry(std::vector<Vertex> vertices,
+                   std::vector<uint32_t> indices);
+
   static std::shared_ptr<Mesh> createBox(float width, float height,
                                          float depth, std::string eid="");
   static std::shared_ptr<Mesh> createSphere(float radius, int latSegments,
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "farixEngine/assets/mesh.hpp"
+#include <cstddef>
+
+namespace farixEngine {
+
+// Quadric error metric edge collapse (Garland & Heckbert). Each collapse
+// moves a vertex onto a neighbour, so the result only uses input vertices
+// and keeps their normals and UVs. Vertices on an open border or a UV/normal
+// seam only collapse into other border or seam vertices, which keeps
+// silhouettes and texture seams in place.
+//
+// Stops at targetIndexCount, or earlier once the cheapest collapse would
+// move the surface by more than maxError times the mesh's diagonal.
+MeshBuffer simplifyMesh(const MeshBuffer &source, size_t targetIndexCount,
+                        float maxError = 0.02f);
+
+} // namespace farixEngine
@@ -5,9 +5,25 @@
 #include <string>
 
 #include <memory>
+#include <vector>
 
 namespace farixEngine {
 
+// One level of the CPU sampling mip chain. Texels are ARGB8888 stored in 4x4
+// tiles (one cache line each) with Morton order inside a tile.
+struct TextureMip {
+  int width = 0;
+  int height = 0;
+  int tilesX = 0;
+  std::vector<uint32_t> texels;
+
+  uint32_t fetch(int x, int y) const {
+    int tile = (y >> 2) * tilesX + (x >> 2);
+    int inner = (x & 1) | ((y & 1) << 1) | ((x & 2) << 1) | ((y & 2) << 2);
+    return texels[(tile << 4) | inner];
+  }
+};
+
 struct Texture : public Asset {
   std::string id;
   std::string path;
@@ -17,6 +33,10 @@ struct Texture : public Asset {
   int texWidth = 0;
   int texHeight = 0;
   int numColCh;
+  // False once every texel is known to be fully opaque.
+  bool hasAlpha = true;
+
+  std::vector<TextureMip> mips;
 
   ~Texture() {
     if (textureSurface)
@@ -28,5 +48,14 @@ struct Texture : public Asset {
   // static std::shared_ptr<Texture> loadFromBmp(const std::string &filename,
   // std::string eid="");
   Uint32 sample(float u, float v) const;
+
+  // Rebuilds the tiled mip chain used by sampleBilinear from texturePixels.
+  // load() and markChanged() build it. A pipelined software renderer may
+  // still be sampling the old chain, so edit pixels after waitForFrame().
+  void buildMipChain();
+  void markChanged() override;
+  // Bilinear sample from the mip level closest to `lod` (log2 of the texel
+  // footprint of one pixel). Samples the base pixels when no chain is built.
+  Uint32 sampleBilinear(float u, float v, float lod) const;
 };
 } // namespace farixEngine
@@ -4,6 +4,7 @@
 #include "farixEngine/assets/mesh.hpp"
 #include "farixEngine/assets/texture.hpp"
 
+#include "farixEngine/math/bounds.hpp"
 #include "farixEngine/math/mat4.hpp"
 #include "farixEngine/math/vec3.hpp"
 #include "farixEngine/utils/uuid.hpp"
@@ -32,6 +33,11 @@ struct TransformComponent {
 
 struct GlobalTransform {
   Mat4 worldMatrix{};
+  // World-space bounds of the entity's mesh, refreshed by HierarchySystem
+  // together with worldMatrix. hasBounds is false for entities without one.
+  AABB worldBounds{};
+  BoundingSphere worldSphere{};
+  bool hasBounds = false;
 };
 
 struct Metadata {
@@ -94,6 +100,16 @@ struct MaterialOverrides {
 
   std::optional<bool> useTexture;
   std::optional<bool> doubleSided;
+
+  bool operator==(const MaterialOverrides &other) const {
+    return baseColor == other.baseColor && ambient == other.ambient &&
+           specular == other.specular && shininess == other.shininess &&
+           diffuse == other.diffuse && texture == other.texture &&
+           useTexture == other.useTexture && doubleSided == other.doubleSided;
+  }
+  bool operator!=(const MaterialOverrides &other) const {
+    return !(*this == other);
+  }
 };
 
 struct MaterialComponent {
@@ -20,12 +20,16 @@
 
 namespace farixEngine {
 using Entity = uint32_t;  
+
+enum class RendererBackend { OpenGL, Software, Headless };
+
 class Engine {
 public:
   Engine();
   ~Engine();
 
-  void init(int width, int height, const char *title);
+  void init(int width, int height, const char *title,
+            RendererBackend backend = RendererBackend::OpenGL);
   void beginFrame(bool &running);
   void endFrame();
   void shutdown();
@@ -42,6 +46,7 @@ private:
   SceneManager* sceneManager = nullptr;
   InputManager inputManager;
   EngineContext *context;
+  AssetManager::ListenerID assetListener = 0;
   bool _running = true;
 };
 } // namespace farixEngine
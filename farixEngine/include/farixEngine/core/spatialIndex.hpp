@@ -0,0 +1,94 @@
+#pragma once
+
+#include "farixEngine/math/bounds.hpp"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace farixEngine {
+
+// Visibility index over renderable entities. Entities start in a loose
+// octree (the static partition); an entity whose bounds change moves to a
+// flat dynamic list that is culled in SIMD batches, and returns to the octree
+// once it has been still for kSettleFrames frames. Octree nodes hold up to
+// kSplitThreshold entities before they subdivide, so the entities of a node
+// are also tested as one batch.
+class SpatialIndex {
+public:
+  using Entity = uint32_t;
+
+  static constexpr uint32_t kSettleFrames = 30;
+
+  // Inserts the entity or records its new bounds; unchanged bounds are a
+  // lookup and a compare.
+  void update(Entity e, const AABB &bounds, const BoundingSphere &sphere);
+  // Entity that is always returned by query(), e.g. a mesh without bounds.
+  void insertUnbounded(Entity e);
+  void remove(Entity e);
+  void clear();
+
+  // Advances the frame counter and moves settled dynamic entities back into
+  // the octree.
+  void endFrame();
+
+  // Appends every entity whose bounds touch the frustum. Octree nodes fully
+  // inside the frustum are taken without testing their entities.
+  void query(const Frustum &frustum, std::vector<Entity> &out) const;
+
+  size_t size() const { return entries.size(); }
+  bool contains(Entity e) const { return entries.count(e) != 0; }
+
+private:
+  enum class Partition : uint8_t { Static, Dynamic, Unbounded };
+
+  struct Entry {
+    AABB bounds;
+    BoundingSphere sphere;
+    Partition partition = Partition::Static;
+    int32_t node = -1;
+    uint32_t slot = 0;
+    uint32_t lastMoved = 0;
+  };
+
+  struct Node {
+    Vec3 center;
+    float halfSize = 0.0f;
+    int32_t parent = -1;
+    int32_t children[8] = {-1, -1, -1, -1, -1, -1, -1, -1};
+    bool split = false;
+    // Entities in this node and below.
+    uint32_t subtreeCount = 0;
+    std::vector<Entity> entities;
+    SphereBatch spheres;
+  };
+
+  static constexpr size_t kSplitThreshold = 128;
+  static constexpr float kMinHalfSize = 0.25f;
+  static constexpr float kMinRootHalfSize = 16.0f;
+
+  void insertStatic(Entity e, Entry &entry);
+  void addToNode(int32_t node, Entity e, Entry &entry);
+  void splitNode(int32_t node);
+  void removeStatic(Entry &entry);
+  void insertDynamic(Entity e, Entry &entry);
+  void removeDynamic(Entry &entry);
+  void removeUnbounded(Entry &entry);
+  void growRoot(const BoundingSphere &sphere);
+  int32_t childFor(int32_t node, const Vec3 &point);
+  void queryNode(int32_t node, const Frustum &frustum, bool inside,
+                 std::vector<Entity> &out) const;
+
+  std::unordered_map<Entity, Entry> entries;
+  std::vector<Node> nodes;
+  int32_t root = -1;
+
+  std::vector<Entity> dynamicEntities;
+  SphereBatch dynamicSpheres;
+  // Scratch visibility flags for batched sphere tests.
+  mutable std::vector<uint8_t> visibleScratch;
+
+  std::vector<Entity> unbounded;
+  uint32_t frame = 0;
+};
+
+} // namespace farixEngine
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "farixEngine/assets/assetManager.hpp"
+#include "farixEngine/math/bounds.hpp"
+#include <cstdint>
+#include <memory>
+#include <set>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace farixEngine {
+
+class World;
+struct Mesh;
+namespace renderer {
+struct MeshData;
+}
+
+// Static meshes merged per material into world-space vertex and index
+// buffers, built once a scene is loaded. An entity is static when neither it
+// nor an ancestor has a RigidBodyComponent or BillboardComponent, it has no
+// material overrides and its material is opaque. Members are grouped into
+// grid cells of clusterSize so each batch still culls as a unit.
+//
+// Batched entities leave the spatial index. When one of them moves, changes
+// mesh, material or overrides, or is destroyed, its batch dissolves and the
+// remaining members are drawn individually until update() merges their cell
+// again. The entity that changed rejoins once its transform has been still
+// for kSettleFrames updates.
+class StaticBatches {
+public:
+  using Entity = uint32_t;
+  using Cell = std::tuple<int, int, int>;
+
+  static constexpr size_t kMaxBatchVertices = 1u << 16;
+  static constexpr uint32_t kSettleFrames = 30;
+
+  struct Batch {
+    AssetID material;
+    Cell cell;
+    std::shared_ptr<renderer::MeshData> mesh;
+    AABB bounds;
+    BoundingSphere sphere;
+    std::vector<Entity> members;
+    bool dissolved = false;
+  };
+
+  // Dissolves any previous batches and merges the current static entities.
+  // World matrices are computed the way HierarchySystem does, so the first
+  // update does not count as movement.
+  void build(World &world, float clusterSize = 32.0f);
+  void clear();
+  // Runs once per frame after transforms are final: settles moved entities
+  // and re-merges the cells whose batches dissolved.
+  void update(World &world);
+  // uuids of the MeshData of dissolved batches since the last call, for the
+  // renderer to drop its GPU copies.
+  std::vector<std::string> takeRetiredMeshes();
+
+  bool isBatched(Entity e) const { return members.count(e) != 0; }
+  // True while the entity's transform, mesh and material still match what
+  // was merged into its batch.
+  bool matches(World &world, Entity e, const Mat4 &worldMatrix) const;
+  // Dissolves the entity's batch. The other members go back into the
+  // spatial index until the next update(); the entity itself is left to the
+  // caller.
+  void release(World &world, Entity e);
+
+  // Appends the indices of the batches that touch the frustum.
+  void query(const Frustum &frustum, std::vector<uint32_t> &out) const;
+
+  const Batch &batch(uint32_t index) const { return batches[index]; }
+  size_t batchCount() const { return batches.size(); }
+  size_t memberCount() const { return members.size(); }
+  bool isSettling(Entity e) const { return moved.count(e) != 0; }
+
+private:
+  struct Member {
+    uint32_t batch = 0;
+    Mat4 worldMatrix;
+    const Mesh *mesh = nullptr;
+    uint32_t meshVersion = 0;
+  };
+
+  struct Moved {
+    Mat4 worldMatrix;
+    uint32_t stillFrames = 0;
+  };
+  using CellKey = std::pair<AssetID, Cell>;
+
+  Cell cellFor(const AABB &bounds) const;
+  // Merges the unbatched static entities, of every cell or only of `only`.
+  void merge(World &world, const std::set<CellKey> *only);
+  // Returns the members other than `skip` to the spatial index.
+  void dissolve(World &world, Batch &batch, Entity skip);
+  void retire(Batch &batch);
+  void compact();
+
+  float clusterSize = 32.0f;
+  std::vector<Batch> batches;
+  std::unordered_map<Entity, Member> members;
+  // Entities that left a batch because they changed, until they settle.
+  std::unordered_map<Entity, Moved> moved;
+  // Cells whose batch dissolved since the last update().
+  std::set<CellKey> dirty;
+  std::vector<std::string> retiredMeshes;
+};
+
+} // namespace farixEngine
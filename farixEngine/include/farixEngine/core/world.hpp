@@ -14,6 +14,8 @@
 
 #include "farixEngine/components/components.hpp"
 #include "farixEngine/core/engineContext.hpp"
+#include "farixEngine/core/spatialIndex.hpp"
+#include "farixEngine/core/staticBatches.hpp"
 #include "farixEngine/ecs/component.hpp"
 #include "farixEngine/ecs/system.hpp"
 #include "farixEngine/script/scriptRegistry.hpp"
@@ -99,6 +101,11 @@ public:
 
   void destroyEntity(Entity e);
 
+  SpatialIndex &getSpatialIndex() { return spatialIndex; }
+  StaticBatches &getStaticBatches() { return staticBatches; }
+  // Merges the current static meshes; see StaticBatches.
+  void buildStaticBatches(float clusterSize = 32.0f);
+
   ComponentManager &getComponentManager();
   std::vector<std::shared_ptr<System>> getSystems();
 
@@ -108,6 +115,8 @@ private:
   Entity _cameraE = 0;
   ComponentManager componentManager;
   SystemManager systemManager;
+  SpatialIndex spatialIndex;
+  StaticBatches staticBatches;
   EngineContext *context = nullptr;
 };
 
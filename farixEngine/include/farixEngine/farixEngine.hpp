@@ -11,6 +11,7 @@
 #include "farixEngine/input/inputManager.hpp"
 #include "farixEngine/math/vec3.hpp"
 #include "farixEngine/renderer/renderer.hpp"
+#include "farixEngine/renderer/headless/headlessRenderer.hpp"
 #include "farixEngine/scene/scene.hpp"
 #include "farixEngine/scene/sceneManager.hpp"
 #include "farixEngine/script/script.hpp"
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "farixEngine/math/mat4.hpp"
+#include "farixEngine/math/vec3.hpp"
+#include "farixEngine/math/vec4.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace farixEngine {
+
+struct AABB {
+  Vec3 min{0.0f};
+  Vec3 max{0.0f};
+
+  Vec3 center() const { return (min + max) * 0.5f; }
+  Vec3 extents() const { return (max - min) * 0.5f; }
+
+  void expand(const Vec3 &point);
+  // Box around the transformed box.
+  AABB transformed(const Mat4 &m) const;
+};
+
+struct BoundingSphere {
+  Vec3 center{0.0f};
+  float radius = 0.0f;
+
+  // Conservative under non-uniform scale: the radius grows with the largest
+  // axis scale.
+  BoundingSphere transformed(const Mat4 &m) const;
+};
+
+// Spheres in structure-of-arrays layout for batched tests.
+struct SphereBatch {
+  std::vector<float> x;
+  std::vector<float> y;
+  std::vector<float> z;
+  std::vector<float> radius;
+
+  void clear();
+  void push(const BoundingSphere &sphere);
+  void set(size_t index, const BoundingSphere &sphere);
+  // Moves the last sphere into index and shrinks the batch by one.
+  void swapRemove(size_t index);
+  size_t size() const { return x.size(); }
+};
+
+enum class Containment { Outside, Intersects, Inside };
+
+// Six inward-facing planes (a, b, c, d) with a * x + b * y + c * z + d >= 0
+// on the inside, extracted from a view-projection matrix.
+struct Frustum {
+  Vec4 planes[6];
+
+  static Frustum fromMatrix(const Mat4 &viewProjection);
+
+  bool intersects(const BoundingSphere &sphere) const;
+  bool intersects(const AABB &box) const;
+  Containment classify(const AABB &box) const;
+
+  // visible[i] is set to 1 when sphere i touches the frustum, 0 otherwise.
+  // Tests eight spheres per iteration with AVX2, four with SSE2.
+  void cullSpheres(const SphereBatch &spheres,
+                   std::vector<uint8_t> &visible) const;
+};
+
+} // namespace farixEngine
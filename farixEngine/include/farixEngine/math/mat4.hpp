@@ -18,6 +18,8 @@ struct Mat4 {
   Vec4 operator*(const Vec4 &v) const;
 
   Mat4 transpose() const;
+  // General inverse; returns identity for singular matrices.
+  Mat4 inverse() const;
 
   Vec4 getRow(int r) const;
   Vec4 getCol(int c) const;
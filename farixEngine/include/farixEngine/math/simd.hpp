@@ -0,0 +1,23 @@
+#pragma once
+
+// Compile-time SIMD feature detection. Kernels pick the widest path that is
+// available and keep a scalar fallback for every other target.
+
+#if defined(__AVX2__)
+#define FARIX_SIMD_AVX2 1
+#include <immintrin.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) ||                                   \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FARIX_SIMD_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if defined(FARIX_SIMD_AVX2)
+#define FARIX_SIMD_WIDTH 8
+#elif defined(FARIX_SIMD_SSE2)
+#define FARIX_SIMD_WIDTH 4
+#else
+#define FARIX_SIMD_WIDTH 1
+#endif
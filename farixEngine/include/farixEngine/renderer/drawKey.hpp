@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace farixEngine::renderer {
+
+// 64-bit draw sort key, most significant field first:
+//
+//   pass (8) | translucent (1) | depth (15) | shader (8) | material (16) |
+//   mesh (16)
+//
+// Opaque draws keep only a coarse depth bucket, ascending, so state changes
+// are grouped within each band while the pass still runs roughly front to
+// back. Translucent draws use the full depth range, inverted, so they run
+// back to front. Shader, material and mesh are truncated GL object names:
+// a collision only costs a redundant bind.
+struct DrawKey {
+  static constexpr int kMeshBits = 16;
+  static constexpr int kMaterialBits = 16;
+  static constexpr int kShaderBits = 8;
+  static constexpr int kDepthBits = 15;
+  static constexpr int kOpaqueDepthBits = 6;
+  static constexpr int kPassBits = 8;
+
+  // depth is normalized view distance, 0 at the near plane and 1 at the far
+  // plane; values outside the range are clamped.
+  static uint64_t make(uint32_t pass, bool translucent, float depth,
+                       uint32_t shader, uint32_t material, uint32_t mesh);
+};
+
+// Stable LSD radix sort of keys, eight bits per pass. order receives the key
+// indices in ascending key order; bytes that are equal across all keys are
+// skipped. scratch is reused between calls.
+void radixSortKeys(const std::vector<uint64_t> &keys,
+                   std::vector<uint32_t> &order,
+                   std::vector<uint32_t> &scratch);
+
+} // namespace farixEngine::renderer
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "farixEngine/renderer/software/softwareRenderer.hpp"
+
+namespace farixEngine::renderer {
+
+// Software rasterizer that renders into an in-memory ARGB8888 framebuffer
+// without creating a window, for benchmarks and golden-image tests on
+// machines without a display server or GPU.
+class HeadlessRenderer : public SoftwareRenderer {
+public:
+  HeadlessRenderer(int width, int height, const char *title = "");
+  ~HeadlessRenderer() override;
+
+  void present() override;
+  void renderText(const UITextDrawCommand &textCommand) override;
+
+  // Readback sees the last presented frame; when pipelined, call
+  // waitForFrame() first.
+  const uint32_t *getFramebuffer() const { return framebuffer; }
+  uint32_t readPixel(int x, int y) const;
+  std::vector<uint32_t> readPixels() const;
+
+  bool savePPM(const std::string &path) const;
+  bool savePNG(const std::string &path) const;
+
+  uint64_t getFrameCount() const { return frameCount; }
+
+private:
+  uint64_t frameCount = 0;
+};
+
+} // namespace farixEngine::renderer
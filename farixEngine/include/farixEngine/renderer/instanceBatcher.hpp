@@ -0,0 +1,112 @@
+#pragma once
+
+#include "farixEngine/assets/material.hpp"
+#include "farixEngine/math/mat4.hpp"
+#include "farixEngine/math/vec4.hpp"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace farixEngine::renderer {
+
+// Per-instance attributes in the layout of the default shader's instance
+// stream: model matrix columns at locations 3-6, color at location 7.
+struct InstanceData {
+  Mat4 model;
+  Vec4 color;
+};
+
+// Draw state shared by every instance of a batch. The pointers are
+// identities only; the batcher never dereferences them.
+struct InstanceKey {
+  const void *mesh = nullptr;
+  const void *texture = nullptr;
+  BlendMode blendMode = BlendMode::Opaque;
+  bool useTexture = false;
+  float ambient = 0.0f;
+  float diffuse = 0.0f;
+  float specular = 0.0f;
+  float shininess = 0.0f;
+
+  bool operator==(const InstanceKey &other) const;
+};
+
+struct InstanceBatch {
+  // First command of the batch; it supplies the draw state.
+  uint32_t command = 0;
+  uint32_t firstInstance = 0;
+  uint32_t instanceCount = 0;
+};
+
+// Receives the packed instance buffer of a pass and the draws that read it.
+class InstanceBackend {
+public:
+  virtual ~InstanceBackend() = default;
+  virtual void uploadInstances(const std::vector<InstanceData> &instances) = 0;
+  virtual void drawInstanced(const InstanceBatch &batch) = 0;
+};
+
+// Keeps every upload and draw so batching can be checked without a GPU.
+class RecordingInstanceBackend : public InstanceBackend {
+public:
+  void uploadInstances(const std::vector<InstanceData> &instances) override {
+    uploads.push_back(instances);
+  }
+  void drawInstanced(const InstanceBatch &batch) override {
+    draws.push_back(batch);
+  }
+  void clear() {
+    uploads.clear();
+    draws.clear();
+  }
+
+  std::vector<std::vector<InstanceData>> uploads;
+  std::vector<InstanceBatch> draws;
+};
+
+// Groups the draws of a pass into instanced batches. Unordered draws (opaque
+// and depth-tested) join any earlier unordered draw with the same key;
+// ordered draws only extend the batch of the draw added just before them, so
+// blending and layering order are preserved. Batches are issued in the order
+// they were opened.
+class InstanceBatcher {
+public:
+  void clear();
+  void add(uint32_t command, const InstanceKey &key, const Mat4 &model,
+           const Vec4 &color, bool ordered);
+
+  // Packs the instances of each batch contiguously, uploads them once and
+  // issues one draw per batch, then clears the batcher.
+  void flush(InstanceBackend &backend);
+
+  size_t instanceCount() const { return pending.size(); }
+  size_t batchCount() const { return groups.size(); }
+
+private:
+  struct KeyHash {
+    size_t operator()(const InstanceKey &key) const;
+  };
+
+  struct Group {
+    InstanceKey key;
+    uint32_t command = 0;
+    uint32_t count = 0;
+    bool ordered = false;
+  };
+
+  struct PendingInstance {
+    uint32_t group = 0;
+    InstanceData data;
+  };
+
+  std::vector<Group> groups;
+  std::vector<PendingInstance> pending;
+  std::unordered_map<InstanceKey, uint32_t, KeyHash> unorderedGroups;
+  // Group touched by the previous add(), or -1.
+  int32_t lastGroup = -1;
+
+  std::vector<InstanceData> packed;
+  std::vector<uint32_t> cursors;
+};
+
+} // namespace farixEngine::renderer
@@ -7,7 +7,7 @@ namespace farixEngine::renderer {
 class EBO {
 public:
   GLuint ID;
-  EBO(GLuint *indices, GLsizeiptr size);
+  EBO(const GLuint *indices, GLsizeiptr size);
   EBO() = default;
 
   void Bind();
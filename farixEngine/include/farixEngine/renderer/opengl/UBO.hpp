@@ -0,0 +1,20 @@
+#pragma once
+
+#include "farixEngine/thirdparty/glad/glad.h"
+
+namespace farixEngine::renderer {
+
+class UBO {
+public:
+  GLuint ID = 0;
+  UBO(GLsizeiptr size);
+  UBO() = default;
+
+  // Replaces the whole store. Respecifying orphans the previous store, so
+  // draws still reading it are not stalled.
+  void Update(const void *data, GLsizeiptr size);
+  void BindBase(GLuint binding);
+  void BindRange(GLuint binding, GLintptr offset, GLsizeiptr size);
+  void Delete();
+};
+} // namespace farixEngine::renderer
@@ -6,7 +6,7 @@ namespace farixEngine::renderer {
 class VBO {
 public:
   GLuint ID;
-  VBO(GLfloat *vertices, GLsizeiptr size);
+  VBO(const GLfloat *vertices, GLsizeiptr size);
   VBO() = default;
 
   void Bind();
@@ -1,15 +1,42 @@
 #pragma once
 
+#include "farixEngine/renderer/instanceBatcher.hpp"
+#include "farixEngine/renderer/opengl/UBO.hpp"
 #include "farixEngine/renderer/opengl/shader.hpp"
+#include "farixEngine/renderer/spriteBatcher.hpp"
 
 #include "farixEngine/renderer/renderData.hpp"
 #include "farixEngine/renderer/renderer.hpp"
 #include "farixEngine/thirdparty/glad/glad.h"
+#include "farixEngine/utils/lruCache.hpp"
 #include <SDL2/SDL.h>
+#include <unordered_set>
 
 namespace farixEngine::renderer {
 
-class OpenGLRenderer : public IRenderer {
+// std140 mirrors of the PassBlock and MaterialBlock uniform blocks in the
+// GL shaders.
+struct PassUniforms {
+  Mat4 camMatrix;
+  Vec4 lightColor;
+  Vec3 lightPos;
+  float padding0 = 0.0f;
+  Vec3 camPos;
+  int32_t enableLight = 0;
+};
+struct MaterialUniforms {
+  float ambient = 0.0f;
+  float diffuse = 0.0f;
+  float specular = 0.0f;
+  float shininess = 0.0f;
+  int32_t useTexture = 0;
+  int32_t padding[3] = {};
+};
+constexpr GLuint kPassBlockBinding = 0;
+constexpr GLuint kMaterialBlockBinding = 1;
+
+class OpenGLRenderer : public IRenderer, private InstanceBackend,
+                       private SpriteBackend {
 public:
   OpenGLRenderer(int width, int height, const char *title);
 
@@ -44,11 +71,105 @@ public:
   createOrGetGPUMesh(const std::shared_ptr<MeshData> &mesh);
   std::shared_ptr<Texture> createOrGetGPUTexture(::farixEngine::Texture *tex);
 
+  void releaseAsset(const std::string &id) override;
+  // Byte budgets of the GPU mesh and texture caches. Evicted objects are
+  // deleted once no recorded command refers to them.
+  void setCacheBudgets(size_t meshBytes, size_t textureBytes);
+  utils::CacheStats meshCacheStats() const { return gpuMeshCache.stats(); }
+  utils::CacheStats textureCacheStats() const {
+    return gpuTextureCache.stats();
+  }
+
+  void applyBlendMode(BlendMode mode);
+
 private:
-  std::unordered_map<std::string, std::shared_ptr<GPUMesh>> gpuMeshCache;
-  std::unordered_map<std::string, std::shared_ptr<Texture>> gpuTextureCache;
+  // GL state left by the previous draw of the pass being replayed, so that
+  // consecutive commands only rebind what differs.
+  struct BoundState {
+    GLuint program = 0;
+    GLuint vao = 0;
+    GLuint texture = 0;
+    GLuint textureUnit = ~0u;
+    // Unit the program's tex0 sampler points at.
+    GLuint samplerUnit = ~0u;
+    // Value of the program's instanced uniform, -1 when unknown.
+    int instanced = -1;
+    // Slot of the material table bound to the material block.
+    uint32_t materialSlot = ~0u;
+  };
+
+  // Deletes the GL objects of evicted entries that are no longer in use.
+  void releaseRetired();
+
+  uint64_t sortKeyFor(const GPUMeshCommand &command) const;
+  void drawMeshCommands(const RenderPass &pass);
+  void resetBoundState();
+  // Binds program, per-pass and material uniforms, texture, blend mode and
+  // VAO for the command, skipping whatever is already bound.
+  void bindDrawState(const GPUMeshCommand &command, uint32_t materialSlot);
+  void uploadPassUniforms(const RenderContext &context);
+  // Appends a material to the table of the pass and returns its slot.
+  uint32_t packMaterial(const MaterialUniforms &material);
+  void uploadMaterials();
+  void setInstanced(bool instanced);
+
+  void uploadInstances(const std::vector<InstanceData> &instances) override;
+  void drawInstanced(const InstanceBatch &batch) override;
+
+  void drawSpriteCommands(const RenderPass &pass);
+  // GL copy of the font's glyph atlas, re-uploaded when glyphs were added.
+  std::shared_ptr<Texture> glyphTexture(Font &font);
+  void
+  uploadSpriteVertices(const std::vector<SpriteVertex> &vertices) override;
+  void drawSprites(const SpriteBatch &batch) override;
+
+  BoundState bound;
+  UBO passUniformBuffer;
+  UBO materialUniformBuffer;
+  // Material blocks of the current pass, materialStride bytes apart to meet
+  // the uniform buffer offset alignment.
+  std::vector<uint8_t> materialTable;
+  size_t materialStride = sizeof(MaterialUniforms);
+  // Material slot of each command of the pass being drawn.
+  std::vector<uint32_t> commandMaterials;
+  std::vector<uint64_t> sortKeys;
+  std::vector<uint32_t> drawOrder;
+  std::vector<uint32_t> sortScratch;
+
+  InstanceBatcher instanceBatcher;
+  // Commands of the pass being flushed; batches index into it.
+  const std::vector<GPUMeshCommand> *batchCommands = nullptr;
+  GLuint instanceBuffer = 0;
+  // VAOs whose instance attributes already point at instanceBuffer.
+  std::unordered_set<GLuint> instancedVaos;
+
+  SpriteBatcher spriteBatcher;
+  // Commands of the pass being flushed; sprite batches index into it.
+  const std::vector<SpriteCommand> *spriteCommands = nullptr;
+  // Stream buffers reused by every pass; created on first use.
+  GLuint spriteVao = 0;
+  GLuint spriteVertexBuffer = 0;
+  GLuint spriteIndexBuffer = 0;
+  size_t spriteQuadCapacity = 0;
+
+  struct GlyphTexture {
+    std::shared_ptr<Texture> texture;
+    uint32_t version = 0;
+  };
+  std::unordered_map<std::string, GlyphTexture> glyphTextures;
+  std::vector<GlyphQuad> glyphQuads;
+
+  BlendMode currentBlendMode = BlendMode::Alpha;
+  utils::LRUCache<std::string, std::shared_ptr<GPUMesh>> gpuMeshCache{
+      256u << 20};
+  utils::LRUCache<std::string, std::shared_ptr<Texture>> gpuTextureCache{
+      512u << 20};
+  // Left the caches but may still be referenced by the recorded frame.
+  std::vector<std::shared_ptr<GPUMesh>> retiredMeshes;
+  std::vector<std::shared_ptr<Texture>> retiredTextures;
   Shader defaultShaderProgram;
   Shader textShaderProgram;
+  Shader spriteShaderProgram;
 };
 
 } // namespace farixEngine::renderer
@@ -9,6 +9,7 @@
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <unordered_map>
 
 namespace farixEngine::renderer {
 
@@ -23,6 +24,10 @@ public:
   void Activate();
   void Delete();
 
+  // Location of an active uniform, -1 when the program does not use it.
+  // Looked up in the table built at link time, not through the driver.
+  GLint uniformLocation(const std::string &name) const;
+
   void setBool(const std::string &name, bool value) const;
   void setInt(const std::string &name, int value) const;
   void setFloat(const std::string &name, float value) const;
@@ -30,6 +35,11 @@ public:
   void setVec3(const std::string &name, const Vec3 &value) const;
   void setVec4(const std::string &name, const Vec4 &value) const;
   void setMat4(const std::string &name, const Mat4 &mat) const;
+
+private:
+  void cacheUniformLocations();
+
+  std::unordered_map<std::string, GLint> uniformLocations;
 };
 
 } // namespace farixEngine::renderer
@@ -12,9 +12,15 @@ public:
   GLuint unit;
   float width;
   float height;
+  // Version of the source asset when it was uploaded.
+  uint32_t version = 0;
   Texture(::farixEngine::Texture *texture, GLenum texType, GLuint slot,
           GLenum format, GLenum pixelType);
 
+  // Re-uploads the pixels into the same texture object, so draws already
+  // queued against it stay valid.
+  void update(::farixEngine::Texture *texture, GLenum format,
+              GLenum pixelType);
   void texUnit(Shader &shader, const char *uniform, GLuint unit);
   void Bind();
   void unBind();
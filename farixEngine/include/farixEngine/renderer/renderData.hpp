@@ -9,6 +9,7 @@
 #include <vector>
 
 #include "farixEngine/assets/font.hpp"
+#include "farixEngine/assets/material.hpp"
 #include "farixEngine/assets/mesh.hpp"
 #include "farixEngine/assets/texture.hpp"
 #include "farixEngine/math/mat4.hpp"
@@ -28,6 +29,10 @@ struct RenderContext {
   bool is2DPass = false;
   bool enableZBuffer = true;
   bool enableLighting = true;
+  bool sortOpaqueFrontToBack = false;
+  // Software renderer: rasterize opaque draws into a G-buffer and shade
+  // each covered pixel once afterwards.
+  bool deferredShading = false;
   Vec4 lightColor = Vec4(1.0f, 1.0f, 1.0f, 1.0f);
   Vec3 lightPos = Vec3(0, 0, -5);
   float nearPlane = 0.1f;
@@ -48,13 +53,20 @@ struct MaterialData {
   Vec2 uvMin = Vec2(0.0f, 0.0f);
   Vec2 uvMax = Vec2(1.0f, 1.0f);
   farixEngine::Texture *texture = nullptr;
+  BlendMode blendMode = BlendMode::Alpha;
+
+  // Alpha blending degrades to opaque when neither the color nor the
+  // sampled texture can produce translucent fragments.
+  BlendMode resolvedBlendMode() const {
+    if (blendMode != BlendMode::Alpha)
+      return blendMode;
+    bool textured = useTexture && texture;
+    bool translucent = textured ? texture->hasAlpha : baseColor.w < 1.0f;
+    return translucent ? BlendMode::Alpha : BlendMode::Opaque;
+  }
 };
 
-struct VertexData {
-  Vec3 position;
-  Vec3 normal;
-  Vec2 uv;
-};
+using VertexData = Vertex;
 
 struct TriangleData {
   uint32_t i0 = 0;
@@ -64,10 +76,20 @@ struct TriangleData {
 
 struct MeshData {
   std::string uuid = "";
-  std::vector<VertexData> vertices;
-  std::vector<uint32_t> indices;
+  // Version of the source asset; GPU copies are rebuilt when it changes.
+  uint32_t version = 0;
+  // Usually the mesh asset's own buffer, shared rather than copied.
+  MeshBufferHandle buffer = std::make_shared<MeshBuffer>();
+
+  const std::vector<VertexData> &vertices() const { return buffer->vertices; }
+  const std::vector<uint32_t> &indices() const { return buffer->indices; }
 };
 
+// uuid of a mesh's level of detail; level 0 is the mesh id itself.
+inline std::string lodMeshId(const std::string &id, size_t level) {
+  return level == 0 ? id : id + "#lod" + std::to_string(level);
+}
+
 struct MeshCommand {
   std::shared_ptr<MeshData> meshData;
   MaterialData matData;
@@ -92,7 +114,10 @@ struct ClippableVertex {
   Vec3 position;
 
   ClippableVertex lerp(const ClippableVertex &other, float t) const {
-    return {cposition + (other.cposition - cposition) * t,
+    // Vec4 +/- reset w, so the clip-space position is blended per component.
+    const Vec4 &a = cposition, &b = other.cposition;
+    return {Vec4(a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t,
+                 a.z + (b.z - a.z) * t, a.w + (b.w - a.w) * t),
             normal + (other.normal - normal) * t, uv + (other.uv - uv) * t,
 
             position + (other.position - position) * t};
@@ -115,15 +140,16 @@ struct GPUMesh {
   VBO vbo;
   EBO ebo;
   size_t indexCount;
+  uint32_t version = 0;
 
 
-  GPUMesh(MeshData &mesh) {
+  GPUMesh(const MeshData &mesh) {
     vao.Bind();
 
-    vbo = VBO((GLfloat *)mesh.vertices.data(),
-              mesh.vertices.size() * sizeof(VertexData));
+    vbo = VBO(reinterpret_cast<const GLfloat *>(mesh.vertices().data()),
+              mesh.vertices().size() * sizeof(VertexData));
 
-    ebo = EBO(mesh.indices.data(), mesh.indices.size() * sizeof(uint32_t));
+    ebo = EBO(mesh.indices().data(), mesh.indices().size() * sizeof(uint32_t));
 
     vao.LinkAttrib(vbo, 0, 3, GL_FLOAT, sizeof(VertexData),
                    (void *)offsetof(VertexData, position));
@@ -136,7 +162,7 @@ struct GPUMesh {
     vbo.Unbind();
     ebo.Unbind(); 
 
-    indexCount = mesh.indices.size();
+    indexCount = mesh.indices().size();
   }
 };
 
@@ -152,6 +178,7 @@ struct GPUMaterialData{
   Vec2 uvMin = Vec2(0.0f, 0.0f);
   Vec2 uvMax = Vec2(1.0f, 1.0f); 
   std::shared_ptr<renderer::Texture> texture = nullptr;
+  BlendMode blendMode = BlendMode::Alpha;
 
 } ;
 
@@ -160,6 +187,33 @@ struct GPUMeshCommand{
   std::shared_ptr<GPUMesh> gpuMesh;
   GPUMaterialData gpuMatData;
   Mat4 modelMatrix;
+  // DrawKey packed at submission; passes replay commands in key order.
+  uint64_t sortKey = 0;
+};
+
+// Quad streamed through the sprite batcher: the unit square centered at the
+// origin, transformed by modelMatrix. A null texture draws flat color.
+struct SpriteCommand {
+  std::shared_ptr<renderer::Texture> texture;
+  Mat4 modelMatrix;
+  Vec2 uvMin = Vec2(0.0f, 0.0f);
+  Vec2 uvMax = Vec2(1.0f, 1.0f);
+  Vec4 color = Vec4(1.0f, 1.0f, 1.0f, 1.0f);
+  BlendMode blendMode = BlendMode::Alpha;
+};
+
+// Frame-wide effects applied by the CPU backends after the last pass.
+// Exposure and tone mapping treat framebuffer values as linear light.
+struct PostProcessSettings {
+  bool fxaa = false;
+  bool toneMapping = false;
+  float exposure = 1.0f;
+  bool srgbEncode = false;
+
+  bool remapsColor() const {
+    return toneMapping || srgbEncode || exposure != 1.0f;
+  }
+  bool enabled() const { return fxaa || remapsColor(); }
 };
 
 struct RenderPass {
@@ -167,6 +221,10 @@ struct RenderPass {
   std::vector<MeshCommand> meshCommands;
   std::vector<UITextDrawCommand> textCommands;
   std::vector<GPUMeshCommand> gpuMeshCommands;
+  std::vector<SpriteCommand> spriteCommands;
+  // Owners of assets the commands reference by raw pointer, held until the
+  // pass has been rendered.
+  std::vector<std::shared_ptr<const Asset>> pinnedAssets;
 };
 
 } // namespace farixEngine::renderer
@@ -28,6 +28,18 @@ public:
 
   virtual void clear(uint32_t color = 0xFF87CEEB) = 0;
   virtual void present() = 0;
+  // Blocks until every submitted frame has been rendered and presented.
+  // Backends that render inside endFrame() return immediately.
+  virtual void waitForFrame() {}
+  // Dynamic resolution: backends that support it render at a reduced
+  // internal resolution while rendering a frame's passes (rasterization,
+  // post-processing and upsampling, not present() or game code) takes longer
+  // than the budget in milliseconds, never below the minimum scale per axis.
+  // A budget of 0 disables scaling.
+  virtual void setRenderTimeBudget(float, float = 0.5f) {}
+  virtual float getResolutionScale() const { return 1.0f; }
+  // Post-process chain for the frames that follow; CPU backends only.
+  virtual void setPostProcess(const PostProcessSettings &) {}
   virtual void submitMesh(const std::shared_ptr<MeshData> mesh,
                           const Mat4 &model, const MaterialData &material) = 0;
 
@@ -42,6 +54,10 @@ public:
   virtual void renderText(const UITextDrawCommand &textCommand) = 0;
   
 
+  // Drops whatever the backend built from the asset; called when the asset
+  // is removed or replaced.
+  virtual void releaseAsset(const std::string &) {}
+
   virtual std::array<int, 2> getScreenSize() = 0;
 
   Vec4 unpackColor(uint32_t color);
@@ -54,7 +70,10 @@ protected:
   int screenWidth = 0;
   int screenHeight = 0;
 
+  // Passes recorded for the frame being built, and the snapshot of the last
+  // submitted frame that the backend renders from.
   std::vector<RenderPass> passes;
+  std::vector<RenderPass> renderPasses;
   RenderPass *activePass = nullptr;
   RenderContext *currentContext = nullptr;
 
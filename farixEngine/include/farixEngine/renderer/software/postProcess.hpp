@@ -0,0 +1,56 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "farixEngine/renderer/renderData.hpp"
+#include "farixEngine/utils/threadPool.hpp"
+
+namespace farixEngine::renderer {
+
+// Lerps two ARGB8888 colors with a weight in [0, 256], two channels per
+// multiply.
+inline uint32_t lerpColor(uint32_t a, uint32_t b, uint32_t weight) {
+  uint32_t inv = 256 - weight;
+  uint32_t rb =
+      (((a & 0x00FF00FF) * inv + (b & 0x00FF00FF) * weight) >> 8) & 0x00FF00FF;
+  uint32_t ag = (((a >> 8) & 0x00FF00FF) * inv +
+                 ((b >> 8) & 0x00FF00FF) * weight) &
+                0xFF00FF00;
+  return rb | ag;
+}
+
+// Post-process chain for ARGB8888 framebuffers: exposure, tone mapping and
+// sRGB encode fused into one lookup table, followed by FXAA on the encoded
+// result. Work is split into rows of tiles on the given pool.
+class PostProcessor {
+public:
+  void apply(const PostProcessSettings &settings, uint32_t *pixels, int width,
+             int height, utils::ThreadPool &pool);
+
+private:
+  static constexpr int kTileRows = 8;
+
+  void buildColorLut(const PostProcessSettings &settings);
+  void prepareRows(uint32_t *pixels, int y0, int y1, bool remap,
+                   bool keepSource);
+  void fxaaRows(uint32_t *pixels, int y0, int y1) const;
+  void fxaaPixel(uint32_t *pixels, int x, int y) const;
+  int lumaAt(int x, int y) const;
+
+  int width = 0;
+  int height = 0;
+
+  std::array<uint8_t, 256> colorLut{};
+  bool lutValid = false;
+  PostProcessSettings lutSettings;
+
+  // Luma of the remapped colors with a one pixel clamped border, so the
+  // neighborhood loads never leave the buffer.
+  std::vector<uint8_t> luma;
+  int lumaStride = 0;
+  std::vector<uint32_t> source;
+};
+
+} // namespace farixEngine::renderer
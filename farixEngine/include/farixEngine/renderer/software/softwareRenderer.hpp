@@ -3,7 +3,13 @@
 
 #include <SDL2/SDL.h>
 
+#include <array>
+#include <atomic>
+#include <condition_variable>
 #include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 #include "farixEngine/assets/font.hpp"
@@ -11,9 +17,27 @@
 #include "farixEngine/math/vec4.hpp"
 #include "farixEngine/renderer/renderData.hpp"
 #include "farixEngine/renderer/renderer.hpp"
+#include "farixEngine/renderer/software/postProcess.hpp"
+#include "farixEngine/utils/threadPool.hpp"
 
 namespace farixEngine::renderer {
 
+// Post-transform vertex shared by every triangle that references it.
+struct TransformedVertex {
+  ClippableVertex vertex;
+};
+
+// A triangle clipped against six planes has at most nine vertices.
+using ClipPolygon = std::array<ClippableVertex, 9>;
+
+// Edge functions E(x, y) = a * x + b * y + c over 28.4 fixed-point
+// coordinates, with the top-left fill bias folded into c.
+struct EdgeSetup {
+  int64_t a[3];
+  int64_t b[3];
+  int64_t c[3];
+};
+
 class SoftwareRenderer : public IRenderer {
 public:
   SoftwareRenderer(int width, int height, const char *title);
@@ -24,6 +48,17 @@ public:
 
   void endPass() override;
   void endFrame() override;
+  void waitForFrame() override;
+
+  // When pipelined, endFrame() hands the recorded passes to a render thread
+  // and returns, so the next frame is simulated while this one rasterizes.
+  // Frames are presented one endFrame() late, or by waitForFrame().
+  void setPipelined(bool enabled);
+  bool isPipelined() const { return pipelined; }
+
+  void setRenderTimeBudget(float budgetMs, float minScale = 0.5f) override;
+  float getResolutionScale() const override { return resolutionScale; }
+  void setPostProcess(const PostProcessSettings &settings) override;
 
   void submitMesh(const std::shared_ptr<MeshData> mesh, const Mat4 &model,
                   const MaterialData &material) override;
@@ -45,6 +80,8 @@ public:
                const RenderContext &ctx) const;
 
   void drawPixel(int x, int y, float z, uint32_t color);
+  void blendPixel(int index, uint32_t color,
+                  BlendMode mode = BlendMode::Alpha);
 
   float edgeFunction(const Vec4 &a, const Vec4 &b, const Vec4 &c) const;
   bool isTriangleValid(const Vec4 &p0, const Vec4 &p1, const Vec4 &p2) const;
@@ -54,15 +91,8 @@ public:
                                                const TriangleData &tri,
                                                const Mat4 &model,
                                                const RenderContext &ctx) const;
-  bool isTriangleVisible(std::array<Vec4, 3> &projected,
-                         const MaterialData &material,
-                         const RenderContext &ctx) const;
-  std::array<Vec2, 3> fetchUVs(const MeshData &mesh, const TriangleData &tri,
-                               const MaterialData &material) const;
-  std::array<Vec3, 3> fetchNs(const MeshData &mesh, const TriangleData &tri,
-                              const MaterialData &material) const;
-  std::array<Vec3, 3> fetchPs(const MeshData &mesh, const TriangleData &tri,
-                              const MaterialData &material) const;
+  bool isTriangleVisible(const Vec4 &c0, const Vec4 &c1, const Vec4 &c2,
+                         const MaterialData &material) const;
 
   Vec4 shadeFragment(const Vec3 &worldPos, const Vec3 &uv, const Vec3 &normal,
                      const RenderContext &ctx, const MaterialData &material);
@@ -77,30 +107,106 @@ public:
   Vec4 toCameraSpace(const Vec3 &pos, const Mat4 &model, const Mat4 &view);
   Vec4 projectToClipSpace(const Vec4 &posCamera, const Mat4 &proj);
   Vec4 ndcToScreen(Vec4 &posClip, int screenWidth, int screenHeight);
-  bool isTriangleVisibleInFrustum(const Vec4 &v0, const Vec4 &v1,
-                                  const Vec4 &v2);
-  std::vector<std::vector<ClippableVertex>>
-  clipTriangleAgainstNearPlane(const ClippableVertex &v0,
-                               const ClippableVertex &v1,
-                               const ClippableVertex &v2);
-
-  void drawTriangle(const MeshData &mesh, const TriangleData &tri,
-                    const Mat4 &model, const RenderContext &ctx,
+  int clipTriangle(const ClippableVertex &v0, const ClippableVertex &v1,
+                   const ClippableVertex &v2, uint32_t clipMask, float guardX,
+                   float guardY, ClipPolygon &out) const;
+
+  void transformVertices(const MeshData &mesh, const Mat4 &model,
+                         const RenderContext &ctx,
+                         const MaterialData &material);
+  void drawTriangle(const TransformedVertex &v0, const TransformedVertex &v1,
+                    const TransformedVertex &v2, const RenderContext &ctx,
                     const MaterialData &material);
 
   void renderMesh(const MeshData &mesh, const Mat4 &model,
                   const MaterialData &material);
 
   void flushTextDraws();
+  void renderFrame();
+  size_t sortDrawOrder(const RenderPass &pass);
+  void resolveDeferred(const RenderContext &ctx);
+  void updateTileDepth(int tileX, int tileY);
+  void widenTileDepth(int tileIndex, float minZ, float maxZ);
 
   std::array<int, 2> getScreenSize() override;
 
+protected:
+  // Allocates the framebuffer and depth buffer only, without any SDL window.
+  SoftwareRenderer(int width, int height);
+
+  static constexpr int kRasterBlockSize = 8;
+  static constexpr int kSubPixelBits = 4;
+  // Triangles may extend this far past the viewport before x/y clipping.
+  static constexpr int kGuardBandPixels = 1024;
+
+  uint32_t *framebuffer = nullptr;
+  std::vector<float> zBuffer;
+  // Internal render target. At full resolution it is the framebuffer itself;
+  // scaled frames render into scaledColor and are upsampled on completion.
+  uint32_t *colorTarget = nullptr;
+  int targetWidth = 0;
+  int targetHeight = 0;
+  std::vector<uint32_t> scaledColor;
+  // Context of the pass being rasterized; currentContext belongs to the
+  // recording side.
+  const RenderContext *rasterContext = nullptr;
+  std::vector<TransformedVertex> transformedVertices;
+  BlendMode activeBlendMode = BlendMode::Alpha;
+
+  // Coarse depth bounds per kRasterBlockSize tile of the depth buffer.
+  int tilesX = 0;
+  int tilesY = 0;
+  std::vector<float> tileMinDepth;
+  std::vector<float> tileMaxDepth;
+  // Tiles whose bounds were only widened by partial writes; the rasterizer
+  // rescans them when a Hi-Z test depends on the exact maximum.
+  std::vector<uint8_t> tileDepthDirty;
+
+  std::vector<uint32_t> drawOrder;
+  std::vector<float> sortDepths;
+
+  // Light direction in view space, computed once per pass.
+  Vec3 lightDirView = Vec3(0, 0, -1);
+
+  // G-buffer for deferred passes. A material id of 0 marks an empty pixel;
+  // other ids index deferredMaterials + 1.
+  uint32_t activeMaterialId = 0;
+  std::vector<const MaterialData *> deferredMaterials;
+  std::vector<uint32_t> gMaterial;
+  std::vector<Vec3> gNormal;
+  std::vector<Vec3> gSurface; // u, v, mip lod
+  std::unique_ptr<utils::ThreadPool> shadingPool;
+  utils::ThreadPool &workerPool();
+
+  // Settings recorded for the next frame, and those of the frame being
+  // rendered.
+  PostProcessSettings postProcess;
+  PostProcessSettings framePostProcess;
+  PostProcessor postProcessor;
+
 private:
+  void renderThreadLoop();
+  void pinAsset(const Asset *asset);
+  void resizeRenderTarget(int width, int height);
+  void upsampleToFramebuffer();
+  void updateResolutionScale(float renderMs);
+
   SDL_Renderer *sdlRenderer = nullptr;
   SDL_Texture *sdlTexture = nullptr;
 
-  uint32_t *framebuffer = nullptr;
-  std::vector<float> zBuffer;
+  bool pipelined = false;
+  std::thread renderThread;
+  std::mutex frameMutex;
+  std::condition_variable frameQueuedCv;
+  std::condition_variable frameDoneCv;
+  bool frameQueued = false;
+  bool framePresentPending = false;
+  bool stopRenderThread = false;
+
+  std::atomic<float> renderBudgetMs{0.0f};
+  std::atomic<float> minResolutionScale{0.5f};
+  std::atomic<float> resolutionScale{1.0f};
+  float smoothedRenderMs = 0.0f;
 };
 
 } // namespace farixEngine::renderer
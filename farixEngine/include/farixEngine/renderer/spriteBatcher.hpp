@@ -0,0 +1,82 @@
+#pragma once
+
+#include "farixEngine/assets/material.hpp"
+#include "farixEngine/math/mat4.hpp"
+#include "farixEngine/math/vec2.hpp"
+#include "farixEngine/math/vec3.hpp"
+#include "farixEngine/math/vec4.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace farixEngine::renderer {
+
+// Vertex of the sprite stream, already in world (or UI) space.
+struct SpriteVertex {
+  Vec3 position;
+  Vec2 uv;
+  Vec4 color;
+};
+
+// Run of consecutive quads that share a texture and blend mode. Quads are
+// four vertices each, wound (-,-) (+,-) (+,+) (-,+) in local space.
+struct SpriteBatch {
+  // First command of the batch; it supplies the texture.
+  uint32_t command = 0;
+  const void *texture = nullptr;
+  BlendMode blendMode = BlendMode::Alpha;
+  uint32_t firstQuad = 0;
+  uint32_t quadCount = 0;
+};
+
+// Receives the vertices of a pass's sprites and the draws that read them.
+class SpriteBackend {
+public:
+  virtual ~SpriteBackend() = default;
+  virtual void
+  uploadSpriteVertices(const std::vector<SpriteVertex> &vertices) = 0;
+  virtual void drawSprites(const SpriteBatch &batch) = 0;
+};
+
+// Keeps every upload and draw so batching can be checked without a GPU.
+class RecordingSpriteBackend : public SpriteBackend {
+public:
+  void uploadSpriteVertices(const std::vector<SpriteVertex> &vertices) override {
+    uploads.push_back(vertices);
+  }
+  void drawSprites(const SpriteBatch &batch) override {
+    draws.push_back(batch);
+  }
+  void clear() {
+    uploads.clear();
+    draws.clear();
+  }
+
+  std::vector<std::vector<SpriteVertex>> uploads;
+  std::vector<SpriteBatch> draws;
+};
+
+// Streams sprites as transformed quads in submission order and starts a new
+// batch whenever the texture or blend mode changes. Each sprite is the unit
+// square centered at the origin, transformed by its (affine) model matrix;
+// the corner at (-0.5, -0.5) takes uvMin and the one at (0.5, 0.5) takes
+// uvMax.
+class SpriteBatcher {
+public:
+  void clear();
+  void add(uint32_t command, const Mat4 &model, const Vec2 &uvMin,
+           const Vec2 &uvMax, const Vec4 &color, const void *texture,
+           BlendMode blendMode);
+
+  // Uploads every quad once and issues one draw per batch, then clears the
+  // batcher.
+  void flush(SpriteBackend &backend);
+
+  size_t quadCount() const { return vertices.size() / 4; }
+  size_t batchCount() const { return batches.size(); }
+
+private:
+  std::vector<SpriteVertex> vertices;
+  std::vector<SpriteBatch> batches;
+};
+
+} // namespace farixEngine::renderer
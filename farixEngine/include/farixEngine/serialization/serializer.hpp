@@ -134,6 +134,7 @@ json Serializer::serializeAsset(std::shared_ptr<T> asset,
 
     j["useTexture"] = asset->useTexture;
     j["doubleSided"] = asset->doubleSided;
+    j["blendMode"] = static_cast<int>(asset->blendMode);
 
   } else if constexpr (std::is_same_v<T, Font>) {
     j["uuid"] = asset->id;
@@ -194,6 +195,8 @@ std::shared_ptr<T> Serializer::deserializeAsset(const json &j,
 
     asset->useTexture = j["useTexture"];
     asset->doubleSided = j["doubleSided"];
+    asset->blendMode = static_cast<BlendMode>(
+        j.value("blendMode", static_cast<int>(BlendMode::Alpha)));
 
     am.add(asset, name);
 
@@ -1,16 +1,19 @@
 #pragma once
 #include "farixEngine/components/components.hpp"
+#include "farixEngine/core/spatialIndex.hpp"
 #include "farixEngine/ecs/system.hpp"
 #include "farixEngine/input/controller.hpp"
 #include "farixEngine/renderer/renderData.hpp"
 #include "farixEngine/renderer/renderer.hpp"
+#include "farixEngine/utils/lruCache.hpp"
 #include <memory>
 
 namespace farixEngine {
 class RenderSystem : public System {
 
 public:
-  RenderSystem() : System("RenderSystem") {}
+  RenderSystem();
+  ~RenderSystem() override;
 
   void onStart(World &world) override {};
 
@@ -29,15 +32,65 @@ public:
   renderer::MeshData loadMeshFromAsset(AssetID id);
   std::shared_ptr<renderer::MeshData> createOrGetMesh(AssetID id);
   renderer::MaterialData& createOrGetMaterial(AssetID id);
+  // Material of the entity with its overrides applied, rebuilt only when
+  // the overrides or the base material changed.
+  const renderer::MaterialData &resolveMaterial(Entity entity,
+                                                MaterialComponent &material);
 
   void applyMaterialOverrides(renderer::MaterialData &matData,
                               MaterialOverrides &overrides);
 
 private:
-  std::unordered_map<AssetID, std::shared_ptr<renderer::MeshData>> meshCache;
-
-  std::unordered_map<AssetID,renderer::MaterialData>
-      materialCache;
+  // Entries remember the asset they were built from and its version, so a
+  // hit is revalidated without an asset lookup. Removing or replacing an
+  // asset erases its entries before the pointer can dangle.
+  struct CachedMesh {
+    std::shared_ptr<renderer::MeshData> data;
+    // One per Mesh::lods entry.
+    std::vector<std::shared_ptr<renderer::MeshData>> lods;
+    const Mesh *asset = nullptr;
+  };
+  struct CachedMaterial {
+    renderer::MaterialData data;
+    const Material *asset = nullptr;
+    uint32_t version = 0;
+  };
+  struct ResolvedMaterial {
+    AssetID material;
+    uint32_t baseVersion = 0;
+    MaterialOverrides overrides;
+    renderer::MaterialData data;
+    uint32_t lastUsed = 0;
+  };
+
+  struct LodState {
+    size_t level = 0;
+    uint32_t lastUsed = 0;
+  };
+  // Relative margin around each Mesh::lods switch size.
+  static constexpr float kLodHysteresis = 0.1f;
+
+  CachedMesh &cachedMesh(const AssetID &id);
+  // Level of detail for the entity's projected height (a fraction of the
+  // viewport), 0 for full detail, kept within the hysteresis band of the
+  // level it had last frame.
+  size_t selectLod(Entity entity, const std::vector<MeshLod> &lods,
+                   float screenSize);
+  CachedMaterial &cachedMaterial(const AssetID &id);
+  void fillMaterialData(const Material &asset, renderer::MaterialData &data);
+
+  // Evicted entries are rebuilt from the asset on their next use.
+  utils::LRUCache<AssetID, CachedMesh> meshCache{1u << 20};
+  utils::LRUCache<AssetID, CachedMaterial> materialCache{1u << 20};
+  // Entries not used by the frame that just rendered are dropped, which
+  // covers destroyed entities, scene reloads and culled entities.
+  std::unordered_map<Entity, ResolvedMaterial> resolvedMaterials;
+  std::unordered_map<Entity, LodState> lodStates;
+  uint32_t frame = 0;
+  AssetManager::ListenerID assetListener = 0;
+
+  std::vector<SpatialIndex::Entity> visibleMeshes;
+  std::vector<uint32_t> visibleBatches;
 
 };
 
@@ -0,0 +1,137 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+namespace farixEngine::utils {
+
+struct CacheStats {
+  uint64_t hits = 0;
+  uint64_t misses = 0;
+  uint64_t evictions = 0;
+  size_t bytes = 0;
+  size_t entries = 0;
+};
+
+// Map bounded by the summed byte cost of its entries. Lookups move an entry
+// to the front; inserts evict from the back until the cache fits its budget
+// again, but never the entry just inserted. Every entry that leaves the
+// cache, by eviction, erase, overwrite or clear, is passed to the release
+// callback first; destroying the cache does not call it. Values live in list
+// nodes, so pointers and references to them stay valid until their entry
+// leaves.
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class LRUCache {
+public:
+  using ReleaseFn = std::function<void(const Key &, Value &)>;
+
+  explicit LRUCache(size_t budgetBytes = SIZE_MAX) : budget(budgetBytes) {}
+
+  LRUCache(const LRUCache &) = delete;
+  LRUCache &operator=(const LRUCache &) = delete;
+
+  void setReleaseCallback(ReleaseFn fn) { onRelease = std::move(fn); }
+
+  void setBudget(size_t budgetBytes) {
+    budget = budgetBytes;
+    trim(nullptr);
+  }
+  size_t getBudget() const { return budget; }
+
+  // Counts a hit or a miss.
+  Value *find(const Key &key) {
+    auto it = index.find(key);
+    if (it == index.end()) {
+      ++counters.misses;
+      return nullptr;
+    }
+    ++counters.hits;
+    entries.splice(entries.begin(), entries, it->second);
+    return &it->second->value;
+  }
+
+  bool contains(const Key &key) const { return index.count(key) != 0; }
+
+  Value &insert(const Key &key, Value value, size_t bytes) {
+    erase(key);
+    entries.push_front({key, std::move(value), bytes});
+    index.emplace(key, entries.begin());
+    counters.bytes += bytes;
+    trim(&entries.front());
+    return entries.front().value;
+  }
+
+  bool erase(const Key &key) {
+    auto it = index.find(key);
+    if (it == index.end())
+      return false;
+    release(it->second);
+    return true;
+  }
+
+  // Erases every entry for which pred(key, value) holds.
+  template <typename Pred> size_t eraseIf(Pred pred) {
+    size_t erased = 0;
+    for (auto it = entries.begin(); it != entries.end();) {
+      auto next = std::next(it);
+      if (pred(it->key, it->value)) {
+        release(it);
+        ++erased;
+      }
+      it = next;
+    }
+    return erased;
+  }
+
+  void clear() {
+    while (!entries.empty())
+      release(std::prev(entries.end()));
+  }
+
+  CacheStats stats() const {
+    CacheStats s = counters;
+    s.entries = entries.size();
+    return s;
+  }
+  void resetCounters() {
+    counters.hits = counters.misses = counters.evictions = 0;
+  }
+
+  size_t size() const { return entries.size(); }
+  size_t bytes() const { return counters.bytes; }
+
+private:
+  struct Entry {
+    Key key;
+    Value value;
+    size_t bytes;
+  };
+  using EntryIt = typename std::list<Entry>::iterator;
+
+  void release(EntryIt it) {
+    if (onRelease)
+      onRelease(it->key, it->value);
+    counters.bytes -= it->bytes;
+    index.erase(it->key);
+    entries.erase(it);
+  }
+
+  void trim(const Entry *keep) {
+    while (counters.bytes > budget && !entries.empty() &&
+           &entries.back() != keep) {
+      release(std::prev(entries.end()));
+      ++counters.evictions;
+    }
+  }
+
+  std::list<Entry> entries;
+  std::unordered_map<Key, EntryIt, Hash> index;
+  size_t budget;
+  CacheStats counters;
+  ReleaseFn onRelease;
+};
+
+} // namespace farixEngine::utils
@@ -0,0 +1,46 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace farixEngine::utils {
+
+// Fixed set of worker threads for data-parallel loops. The calling thread
+// takes part in every job, so a pool of N workers runs N + 1 ways.
+class ThreadPool {
+public:
+  explicit ThreadPool(unsigned workerCount = defaultWorkerCount());
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  // Calls fn(i) for every i in [0, count) and returns once all calls are done.
+  void parallelFor(int count, const std::function<void(int)> &fn);
+
+  unsigned getWorkerCount() const { return workers.size(); }
+
+  static unsigned defaultWorkerCount();
+
+private:
+  void workerLoop();
+  void runJob();
+
+  std::vector<std::thread> workers;
+  std::mutex mutex;
+  std::condition_variable wake;
+  std::condition_variable done;
+
+  const std::function<void(int)> *job = nullptr;
+  int jobCount = 0;
+  std::atomic<int> nextIndex{0};
+  unsigned busyWorkers = 0;
+  uint64_t generation = 0;
+  bool stopping = false;
+};
+
+} // namespace farixEngine::utils
@@ -5,8 +5,9 @@
 
 namespace farixEngine {
 
-void Application::run(int width, int height, const char *title) {
-  engine.init(width, height, title);
+void Application::run(int width, int height, const char *title,
+                      RendererBackend backend) {
+  engine.init(width, height, title, backend);
   EngineServices::get().getEngineRegistry().registerDefaults();
 
   onStart();
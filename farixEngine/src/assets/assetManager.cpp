@@ -0,0 +1,45 @@
+#include "farixEngine/assets/assetManager.hpp"
+#include <vector>
+
+namespace farixEngine {
+
+bool AssetManager::remove(const std::string &idOrName) {
+  UUID id = idOrName;
+  if (auto it = nameToUUIDMap.find(idOrName); it != nameToUUIDMap.end())
+    id = it->second;
+  if (!allAssetsRaw.count(id))
+    return false;
+
+  notifyRemoved(id);
+
+  if (auto it = eraseTyped.find(id); it != eraseTyped.end()) {
+    it->second();
+    eraseTyped.erase(it);
+  }
+  allAssetsRaw.erase(id);
+  if (auto it = uuidToNameMap.find(id); it != uuidToNameMap.end()) {
+    nameToUUIDMap.erase(it->second);
+    uuidToNameMap.erase(it);
+  }
+  return true;
+}
+
+AssetManager::ListenerID AssetManager::onAssetRemoved(RemovalListener callback) {
+  ListenerID id = nextListenerID++;
+  removalListeners[id] = std::move(callback);
+  return id;
+}
+
+void AssetManager::removeListener(ListenerID id) { removalListeners.erase(id); }
+
+void AssetManager::notifyRemoved(const AssetID &id) {
+  // Listeners may unregister themselves while being notified.
+  std::vector<RemovalListener> callbacks;
+  callbacks.reserve(removalListeners.size());
+  for (auto &[listenerId, callback] : removalListeners)
+    callbacks.push_back(callback);
+  for (auto &callback : callbacks)
+    callback(id);
+}
+
+} // namespace farixEngine
@@ -0,0 +1,206 @@
+#include "farixEngine/assets/glyphAtlas.hpp"
+#include <SDL2/SDL.h>
+#include <algorithm>
+#include <iostream>
+
+namespace farixEngine {
+
+namespace {
+
+// Decodes one code point and advances i; malformed bytes decode as '?'.
+uint32_t decodeUtf8(const std::string &text, size_t &i) {
+  unsigned char c = static_cast<unsigned char>(text[i++]);
+  if (c < 0x80)
+    return c;
+
+  int extra = c >= 0xF0 ? 3 : c >= 0xE0 ? 2 : c >= 0xC0 ? 1 : -1;
+  if (extra < 0 || i + extra > text.size())
+    return '?';
+  uint32_t codepoint = c & (0x3F >> extra);
+  for (int k = 0; k < extra; ++k) {
+    unsigned char next = static_cast<unsigned char>(text[i]);
+    if ((next & 0xC0) != 0x80)
+      return '?';
+    codepoint = (codepoint << 6) | (next & 0x3F);
+    ++i;
+  }
+  return codepoint;
+}
+
+int nextPowerOfTwo(int v) {
+  int p = 1;
+  while (p < v)
+    p <<= 1;
+  return p;
+}
+
+} // namespace
+
+GlyphAtlas::GlyphAtlas(TTF_Font *font) : font(font) {
+  if (font)
+    fontHeight = std::max(1, TTF_FontHeight(font));
+
+  // Room for roughly 256 line-height cells: ASCII plus a few hundred other
+  // glyphs.
+  atlasWidth = std::clamp(nextPowerOfTwo(fontHeight * 16), 256, 4096);
+  atlasHeight = atlasWidth;
+  atlasPixels.assign(size_t(atlasWidth) * atlasHeight * 4, 0);
+  for (size_t i = 0; i < atlasPixels.size(); i += 4) {
+    atlasPixels[i] = 255;
+    atlasPixels[i + 1] = 255;
+    atlasPixels[i + 2] = 255;
+  }
+
+  for (uint32_t c = 32; c < 127; ++c)
+    glyph(c);
+}
+
+const Glyph *GlyphAtlas::glyph(uint32_t codepoint) {
+  // Code points that cannot be packed remember the fallback glyph.
+  auto fallback = [&]() {
+    const Glyph *question = codepoint == '?' ? nullptr : glyph('?');
+    return question ? *question : Glyph();
+  };
+
+  if (codepoint < 128) {
+    if (!asciiPacked[codepoint]) {
+      asciiPacked[codepoint] = true;
+      if (!pack(codepoint, ascii[codepoint]))
+        ascii[codepoint] = fallback();
+    }
+    return &ascii[codepoint];
+  }
+
+  if (auto it = extended.find(codepoint); it != extended.end())
+    return &it->second;
+  Glyph packed;
+  if (!pack(codepoint, packed))
+    packed = fallback();
+  return &extended.emplace(codepoint, packed).first->second;
+}
+
+bool GlyphAtlas::pack(uint32_t codepoint, Glyph &glyph) {
+  if (!font)
+    return false;
+
+  int minX, maxX, minY, maxY, advance;
+  if (TTF_GlyphMetrics32(font, codepoint, &minX, &maxX, &minY, &maxY,
+                         &advance) != 0)
+    return false;
+  glyph = Glyph();
+  glyph.advance = advance;
+
+  SDL_Surface *rendered =
+      TTF_RenderGlyph32_Blended(font, codepoint, SDL_Color{255, 255, 255, 255});
+  if (!rendered)
+    return true;
+  SDL_Surface *rgba =
+      SDL_ConvertSurfaceFormat(rendered, SDL_PIXELFORMAT_RGBA32, 0);
+  SDL_FreeSurface(rendered);
+  if (!rgba) {
+    std::cerr << "SDL_ConvertSurfaceFormat failed\n";
+    return true;
+  }
+
+  // The surface is a full line-height cell with the pen at x = 0; only the
+  // covered part is stored.
+  auto alphaAt = [&](int x, int y) {
+    return static_cast<const uint8_t *>(rgba->pixels)[y * rgba->pitch + x * 4 +
+                                                       3];
+  };
+  int x0 = rgba->w, y0 = rgba->h, x1 = -1, y1 = -1;
+  for (int y = 0; y < rgba->h; ++y) {
+    for (int x = 0; x < rgba->w; ++x) {
+      if (alphaAt(x, y)) {
+        x0 = std::min(x0, x);
+        x1 = std::max(x1, x);
+        y0 = std::min(y0, y);
+        y1 = std::max(y1, y);
+      }
+    }
+  }
+  if (x1 < 0) {
+    SDL_FreeSurface(rgba);
+    return true;
+  }
+
+  const int w = x1 - x0 + 1;
+  const int h = y1 - y0 + 1;
+  if (shelfX + w + kPadding > atlasWidth) {
+    shelfX = 0;
+    shelfY += shelfHeight + kPadding;
+    shelfHeight = 0;
+  }
+  if (w + kPadding > atlasWidth || shelfY + h + kPadding > atlasHeight) {
+    SDL_FreeSurface(rgba);
+    if (!full)
+      std::cerr << "Glyph atlas full; missing glyphs are drawn as '?'\n";
+    full = true;
+    return false;
+  }
+
+  for (int y = 0; y < h; ++y) {
+    uint8_t *row =
+        atlasPixels.data() + (size_t(shelfY + y) * atlasWidth + shelfX) * 4;
+    for (int x = 0; x < w; ++x)
+      row[x * 4 + 3] = alphaAt(x0 + x, y0 + y);
+  }
+  SDL_FreeSurface(rgba);
+
+  glyph.atlasX = shelfX;
+  glyph.atlasY = shelfY;
+  glyph.width = w;
+  glyph.height = h;
+  glyph.offsetX = x0;
+  glyph.offsetY = y0;
+  shelfX += w + kPadding;
+  shelfHeight = std::max(shelfHeight, h);
+  ++atlasVersion;
+  return true;
+}
+
+Vec2 GlyphAtlas::layout(const std::string &text,
+                        std::vector<GlyphQuad> &out) {
+  // Glyphs are placed in pixels first and centered once the block size is
+  // known.
+  const size_t first = out.size();
+  int penX = 0, line = 0, widest = 0;
+  for (size_t i = 0; i < text.size();) {
+    uint32_t codepoint = decodeUtf8(text, i);
+    if (codepoint == '\n') {
+      widest = std::max(widest, penX);
+      penX = 0;
+      ++line;
+      continue;
+    }
+    const Glyph *g = glyph(codepoint);
+    if (g->width > 0) {
+      GlyphQuad quad;
+      quad.min = Vec2(float(penX + g->offsetX),
+                      float(line * fontHeight + g->offsetY + g->height));
+      quad.max = Vec2(float(penX + g->offsetX + g->width),
+                      float(line * fontHeight + g->offsetY));
+      quad.uvMin = Vec2(float(g->atlasX) / atlasWidth,
+                        float(g->atlasY + g->height) / atlasHeight);
+      quad.uvMax = Vec2(float(g->atlasX + g->width) / atlasWidth,
+                        float(g->atlasY) / atlasHeight);
+      out.push_back(quad);
+    }
+    penX += g->advance;
+  }
+  widest = std::max(widest, penX);
+
+  const float scale = 1.0f / fontHeight;
+  const float halfWidth = widest * scale * 0.5f;
+  const float halfHeight = (line + 1) * 0.5f;
+  for (size_t i = first; i < out.size(); ++i) {
+    GlyphQuad &quad = out[i];
+    quad.min = Vec2(quad.min.x * scale - halfWidth,
+                    halfHeight - quad.min.y * scale);
+    quad.max = Vec2(quad.max.x * scale - halfWidth,
+                    halfHeight - quad.max.y * scale);
+  }
+  return Vec2(widest * scale, float(line + 1));
+}
+
+} // namespace farixEngine
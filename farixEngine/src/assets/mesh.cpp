@@ -1,6 +1,9 @@
 #include "farixEngine/assets/mesh.hpp"
+#include "farixEngine/assets/meshSimplifier.hpp"
 #include "farixEngine/math/vec3.hpp"
 #include "farixEngine/utils/uuid.hpp"
+#include <algorithm>
+#include <cmath>
 #include <fstream>
 #include <iostream>
 #include <memory>
@@ -19,15 +22,14 @@ mesh->id = eid.empty() ? utils::generateUUID() : eid;
   float w = size[0] / 2.0f; 
   float h = size[1] / 2.0f;
 
-  mesh->vertices = {
-      {Vec3(-w, -h, 0), Vec3(0, 0, 1), Vec2(0, 0)},
-      {Vec3(w, -h, 0), Vec3(0, 0, 1), Vec2(1, 0)},
-      {Vec3(w, h, 0), Vec3(0, 0, 1), Vec2(1, 1)},
-      {Vec3(-w, h, 0), Vec3(0, 0, 1), Vec2(0, 1)},
-  };
-
-  mesh->indices = {0, 1, 2, 0, 2, 3};
-
+  mesh->setGeometry(
+      {
+          {Vec3(-w, -h, 0), Vec3(0, 0, 1), Vec2(0, 0)},
+          {Vec3(w, -h, 0), Vec3(0, 0, 1), Vec2(1, 0)},
+          {Vec3(w, h, 0), Vec3(0, 0, 1), Vec2(1, 1)},
+          {Vec3(-w, h, 0), Vec3(0, 0, 1), Vec2(0, 1)},
+      },
+      {0, 1, 2, 0, 2, 3});
   return mesh;
 }
 
@@ -37,6 +39,8 @@ std::shared_ptr<Mesh> Mesh::createSphere(float radius, int latSegments,
   mesh->type = "Sphere";
   mesh->sphereData = {radius, (float)latSegments, (float)lonSegments};
 mesh->id = eid.empty() ? utils::generateUUID() : eid;
+  std::vector<Vertex> vertices;
+  std::vector<uint32_t> indices;
   for (int lat = 0; lat <= latSegments; ++lat) {
     float theta = lat * M_PI / latSegments;
     float sinTheta = sin(theta);
@@ -51,7 +55,7 @@ mesh->id = eid.empty() ? utils::generateUUID() : eid;
       Vec3 position = normal * radius;
       Vec2 uv((float)lon / lonSegments, 1.0f - (float)lat / latSegments);
 
-      mesh->vertices.push_back({position, normal, uv});
+      vertices.push_back({position, normal, uv});
     }
   }
 
@@ -60,16 +64,17 @@ mesh->id = eid.empty() ? utils::generateUUID() : eid;
       int current = lat * (lonSegments + 1) + lon;
       int next = current + lonSegments + 1;
 
-      mesh->indices.push_back(current);
-      mesh->indices.push_back(current + 1);
-      mesh->indices.push_back(next);
+      indices.push_back(current);
+      indices.push_back(current + 1);
+      indices.push_back(next);
 
-      mesh->indices.push_back(next);
-      mesh->indices.push_back(current + 1);
-      mesh->indices.push_back(next + 1);
+      indices.push_back(next);
+      indices.push_back(current + 1);
+      indices.push_back(next + 1);
     }
   }
 
+  mesh->setGeometry(std::move(vertices), std::move(indices));
   return mesh;
 }
 
@@ -82,7 +87,7 @@ std::shared_ptr<Mesh> Mesh::createBox(float width, float height, float depth, st
   float h = height / 2.0f;
   float d = depth / 2.0f;
 
-  mesh->vertices = {
+  std::vector<Vertex> vertices = {
       // Front face
       {{-w, -h, d}, {0, 0, 1}, {0, 0}},
       {{w, -h, d}, {0, 0, 1}, {1, 0}},
@@ -121,20 +126,77 @@ std::shared_ptr<Mesh> Mesh::createBox(float width, float height, float depth, st
   };
 
   // Indices for each face (two triangles per face)
+  std::vector<uint32_t> indices;
   for (int face = 0; face < 6; ++face) {
     int base = face * 4;
-    mesh->indices.push_back(base + 0);
-    mesh->indices.push_back(base + 1);
-    mesh->indices.push_back(base + 2);
+    indices.push_back(base + 0);
+    indices.push_back(base + 1);
+    indices.push_back(base + 2);
 
-    mesh->indices.push_back(base + 0);
-    mesh->indices.push_back(base + 2);
-    mesh->indices.push_back(base + 3);
+    indices.push_back(base + 0);
+    indices.push_back(base + 2);
+    indices.push_back(base + 3);
   }
 
+  mesh->setGeometry(std::move(vertices), std::move(indices));
   return mesh;
 }
 
+void Mesh::setGeometry(std::vector<Vertex> vertices,
+                       std::vector<uint32_t> indices) {
+  auto next = std::make_shared<MeshBuffer>();
+  next->vertices = std::move(vertices);
+  next->indices = std::move(indices);
+  buffer = std::move(next);
+  lods.clear();
+  computeBounds();
+  markChanged();
+}
+
+void Mesh::generateLods(size_t maxLevels) {
+  // Below this many triangles a level saves less than the switch costs.
+  constexpr size_t kMinLodTriangles = 128;
+
+  lods.clear();
+  MeshBufferHandle previous = buffer;
+  float screenSize = 0.25f;
+  for (size_t level = 0; level < maxLevels; ++level) {
+    size_t target = previous->indices.size() / 6 * 3;
+    if (target < kMinLodTriangles * 3)
+      break;
+    auto simplified =
+        std::make_shared<MeshBuffer>(simplifyMesh(*previous, target));
+    if (simplified->indices.size() * 4 > previous->indices.size() * 3)
+      break;
+    lods.push_back({simplified, screenSize});
+    previous = std::move(simplified);
+    screenSize *= 0.5f;
+  }
+  markChanged();
+}
+
+void Mesh::computeBounds() {
+  const std::vector<Vertex> &vertices = buffer->vertices;
+  if (vertices.empty()) {
+    bounds = AABB();
+    boundingSphere = BoundingSphere();
+    return;
+  }
+
+  bounds.min = bounds.max = vertices[0].position;
+  for (const Vertex &v : vertices)
+    bounds.expand(v.position);
+
+  // Centered on the box; tighter than the box's own circumsphere.
+  boundingSphere.center = bounds.center();
+  float radiusSq = 0.0f;
+  for (const Vertex &v : vertices) {
+    Vec3 d = v.position - boundingSphere.center;
+    radiusSq = std::max(radiusSq, d.dot(d));
+  }
+  boundingSphere.radius = std::sqrt(radiusSq);
+}
+
 std::shared_ptr<Mesh> Mesh::load(const std::string&filename, const std::string  eid){
   return loadFromObj(filename, eid);
 }
@@ -250,6 +312,8 @@ std::shared_ptr<Mesh> Mesh::loadFromObj(const std::string &filename, std::string
   }
 
   std::unordered_map<Vertex, uint32_t> vertexToIndex;
+  std::vector<Vertex> vertices;
+  std::vector<uint32_t> indices;
 
   auto checkVertex = [&](const Vertex &v) -> uint32_t {
     auto it = vertexToIndex.find(v);
@@ -257,8 +321,8 @@ std::shared_ptr<Mesh> Mesh::loadFromObj(const std::string &filename, std::string
       return it->second;
     }
 
-    uint32_t newIndex = static_cast<uint32_t>(mesh->vertices.size());
-    mesh->vertices.push_back(v);
+    uint32_t newIndex = static_cast<uint32_t>(vertices.size());
+    vertices.push_back(v);
     vertexToIndex[v] = newIndex;
     return newIndex;
   };
@@ -271,13 +335,15 @@ std::shared_ptr<Mesh> Mesh::loadFromObj(const std::string &filename, std::string
     
 
     uint32_t i1 = checkVertex(v1);
-    mesh->indices.push_back(i1);
+    indices.push_back(i1);
     uint32_t i2 = checkVertex(v2);
-    mesh->indices.push_back(i2);
+    indices.push_back(i2);
     uint32_t i3 = checkVertex(v3);
-    mesh->indices.push_back(i3);
+    indices.push_back(i3);
   }
 
+  mesh->setGeometry(std::move(vertices), std::move(indices));
+  mesh->generateLods();
   return mesh;
 }
 } // namespace farixEngine
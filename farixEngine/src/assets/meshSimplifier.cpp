@@ -0,0 +1,374 @@
+#include "farixEngine/assets/meshSimplifier.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace farixEngine {
+
+namespace {
+
+// Squared distances to a set of planes, weighted by the area they came from.
+struct Quadric {
+  double xx = 0, xy = 0, xz = 0, yy = 0, yz = 0, zz = 0;
+  double x = 0, y = 0, z = 0, c = 0;
+  double weight = 0;
+
+  static Quadric plane(const Vec3 &n, float d, double w) {
+    Quadric q;
+    q.xx = w * n.x * n.x;
+    q.xy = w * n.x * n.y;
+    q.xz = w * n.x * n.z;
+    q.yy = w * n.y * n.y;
+    q.yz = w * n.y * n.z;
+    q.zz = w * n.z * n.z;
+    q.x = w * n.x * d;
+    q.y = w * n.y * d;
+    q.z = w * n.z * d;
+    q.c = w * d * d;
+    q.weight = w;
+    return q;
+  }
+
+  Quadric &operator+=(const Quadric &o) {
+    xx += o.xx;
+    xy += o.xy;
+    xz += o.xz;
+    yy += o.yy;
+    yz += o.yz;
+    zz += o.zz;
+    x += o.x;
+    y += o.y;
+    z += o.z;
+    c += o.c;
+    weight += o.weight;
+    return *this;
+  }
+
+  // Mean squared distance from p to the planes.
+  double error(const Vec3 &p) const {
+    if (weight <= 0.0)
+      return 0.0;
+    double e = xx * p.x * p.x + yy * p.y * p.y + zz * p.z * p.z +
+               2.0 * (xy * p.x * p.y + xz * p.x * p.z + yz * p.y * p.z) +
+               2.0 * (x * p.x + y * p.y + z * p.z) + c;
+    return std::max(e, 0.0) / weight;
+  }
+};
+
+enum class Kind : uint8_t { Manifold, Seam, Border, Locked };
+
+// Seam and border vertices may only slide along an edge of their own kind,
+// onto a vertex that is on the seam or border too.
+bool canCollapse(Kind from, Kind to, bool seamEdge, bool borderEdge) {
+  switch (from) {
+  case Kind::Manifold:
+    return true;
+  case Kind::Seam:
+    return seamEdge && to != Kind::Manifold;
+  case Kind::Border:
+    return borderEdge && to != Kind::Manifold;
+  case Kind::Locked:
+    return false;
+  }
+  return false;
+}
+
+float attributeDistance(const Vertex &a, const Vertex &b) {
+  Vec3 dn = a.normal - b.normal;
+  Vec2 duv = a.uv - b.uv;
+  return dn.dot(dn) + duv.x * duv.x + duv.y * duv.y;
+}
+
+uint64_t edgeKey(uint32_t a, uint32_t b) {
+  if (a > b)
+    std::swap(a, b);
+  return (uint64_t(a) << 32) | b;
+}
+
+struct EdgeUse {
+  uint32_t count = 0;
+  // The vertices of the first triangle that used the edge. A later triangle
+  // using other vertices at the same positions makes it a seam edge.
+  uint64_t wedges = 0;
+  bool seam = false;
+};
+
+struct Collapse {
+  uint32_t from;
+  uint32_t to;
+  double cost;
+};
+
+} // namespace
+
+MeshBuffer simplifyMesh(const MeshBuffer &source, size_t targetIndexCount,
+                        float maxError) {
+  const std::vector<Vertex> &vertices = source.vertices;
+  std::vector<uint32_t> indices = source.indices;
+  indices.resize(indices.size() / 3 * 3);
+  if (indices.size() <= targetIndexCount || vertices.empty())
+    return source;
+
+  // Vertices sharing a position form one group; collapses move whole groups
+  // and the triangles' corners follow to the closest vertex of the target.
+  std::vector<uint32_t> order;
+  std::vector<bool> used(vertices.size(), false);
+  for (uint32_t v : indices) {
+    if (!used[v])
+      order.push_back(v);
+    used[v] = true;
+  }
+  std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+    const Vec3 &p = vertices[a].position;
+    const Vec3 &q = vertices[b].position;
+    return std::tie(p.x, p.y, p.z, a) < std::tie(q.x, q.y, q.z, b);
+  });
+  std::vector<uint32_t> group(vertices.size(), 0);
+  std::vector<std::vector<uint32_t>> wedges;
+  for (size_t i = 0; i < order.size(); ++i) {
+    if (i == 0 ||
+        !(vertices[order[i]].position == vertices[order[i - 1]].position))
+      wedges.emplace_back();
+    group[order[i]] = static_cast<uint32_t>(wedges.size() - 1);
+    wedges.back().push_back(order[i]);
+  }
+  const size_t groupCount = wedges.size();
+  auto position = [&](uint32_t g) -> const Vec3 & {
+    return vertices[wedges[g][0]].position;
+  };
+
+  std::vector<uint32_t> collapseTo(groupCount);
+  std::iota(collapseTo.begin(), collapseTo.end(), 0);
+
+  auto nearestWedge = [&](uint32_t g, const Vertex &like) {
+    uint32_t best = wedges[g][0];
+    float bestDistance = std::numeric_limits<float>::max();
+    for (uint32_t w : wedges[g]) {
+      float distance = attributeDistance(vertices[w], like);
+      if (distance < bestDistance) {
+        best = w;
+        bestDistance = distance;
+      }
+    }
+    return best;
+  };
+
+  // Applies this pass's collapses and drops the triangles they flattened.
+  auto compact = [&]() {
+    size_t write = 0;
+    for (size_t t = 0; t < indices.size(); t += 3) {
+      uint32_t corner[3];
+      for (int k = 0; k < 3; ++k) {
+        uint32_t v = indices[t + k];
+        uint32_t target = collapseTo[group[v]];
+        corner[k] = target == group[v] ? v : nearestWedge(target, vertices[v]);
+      }
+      if (group[corner[0]] == group[corner[1]] ||
+          group[corner[1]] == group[corner[2]] ||
+          group[corner[0]] == group[corner[2]])
+        continue;
+      for (int k = 0; k < 3; ++k)
+        indices[write++] = corner[k];
+    }
+    indices.resize(write);
+  };
+  compact();
+
+  std::unordered_map<uint64_t, EdgeUse> edges;
+  auto countEdges = [&]() {
+    edges.clear();
+    for (size_t t = 0; t < indices.size(); t += 3) {
+      for (int k = 0; k < 3; ++k) {
+        uint32_t a = indices[t + k];
+        uint32_t b = indices[t + (k + 1) % 3];
+        EdgeUse &use = edges[edgeKey(group[a], group[b])];
+        if (use.count++ == 0)
+          use.wedges = edgeKey(a, b);
+        else if (use.wedges != edgeKey(a, b))
+          use.seam = true;
+      }
+    }
+  };
+
+  std::vector<Quadric> quadrics(groupCount);
+  AABB bounds;
+  bounds.min = bounds.max = position(0);
+  countEdges();
+  for (size_t t = 0; t < indices.size(); t += 3) {
+    const Vec3 &p0 = vertices[indices[t]].position;
+    const Vec3 &p1 = vertices[indices[t + 1]].position;
+    const Vec3 &p2 = vertices[indices[t + 2]].position;
+    Vec3 normal = (p1 - p0).cross(p2 - p0);
+    float doubleArea = normal.length();
+    if (doubleArea <= 0.0f)
+      continue;
+    normal = normal / doubleArea;
+    Quadric q = Quadric::plane(normal, -normal.dot(p0), doubleArea * 0.5);
+    for (int k = 0; k < 3; ++k) {
+      quadrics[group[indices[t + k]]] += q;
+      bounds.expand(vertices[indices[t + k]].position);
+    }
+
+    // Open edges also get a plane through them, perpendicular to the
+    // surface, so the outline resists being pulled inwards.
+    for (int k = 0; k < 3; ++k) {
+      uint32_t a = indices[t + k];
+      uint32_t b = indices[t + (k + 1) % 3];
+      if (edges[edgeKey(group[a], group[b])].count != 1)
+        continue;
+      Vec3 edge = vertices[b].position - vertices[a].position;
+      float lengthSq = edge.dot(edge);
+      Vec3 side = edge.cross(normal).normalized();
+      Quadric border = Quadric::plane(
+          side, -side.dot(vertices[a].position), lengthSq);
+      quadrics[group[a]] += border;
+      quadrics[group[b]] += border;
+    }
+  }
+
+  const Vec3 diagonal = bounds.max - bounds.min;
+  const double limit =
+      double(maxError) * maxError * double(diagonal.dot(diagonal));
+
+  std::vector<Kind> kinds(groupCount);
+  std::vector<uint8_t> touched(groupCount);
+  std::vector<uint32_t> triangleOffsets;
+  std::vector<uint32_t> triangles;
+  std::vector<Collapse> collapses;
+
+  auto flips = [&](uint32_t from, uint32_t to) {
+    for (uint32_t i = triangleOffsets[from]; i < triangleOffsets[from + 1];
+         ++i) {
+      const size_t t = size_t(triangles[i]) * 3;
+      uint32_t g[3];
+      for (int k = 0; k < 3; ++k)
+        g[k] = collapseTo[group[indices[t + k]]];
+      if (g[0] == to || g[1] == to || g[2] == to || g[0] == g[1] ||
+          g[1] == g[2] || g[0] == g[2])
+        continue;
+      Vec3 p[3], q[3];
+      for (int k = 0; k < 3; ++k) {
+        p[k] = position(g[k]);
+        q[k] = g[k] == from ? position(to) : p[k];
+      }
+      Vec3 before = (p[1] - p[0]).cross(p[2] - p[0]);
+      Vec3 after = (q[1] - q[0]).cross(q[2] - q[0]);
+      // Also rejects turns close to a right angle, which leave slivers
+      // that a later pass could fold over.
+      if (before.dot(after) <= 0.25f * before.length() * after.length())
+        return true;
+    }
+    return false;
+  };
+
+  while (indices.size() > targetIndexCount) {
+    const size_t triangleCount = indices.size() / 3;
+    countEdges();
+
+    // A vertex on both a seam and a border, or on a non-manifold edge,
+    // stays put.
+    std::fill(kinds.begin(), kinds.end(), Kind::Manifold);
+    auto mark = [&](uint32_t g, Kind kind) {
+      if (kinds[g] == Kind::Manifold || kinds[g] == kind)
+        kinds[g] = kind;
+      else
+        kinds[g] = Kind::Locked;
+    };
+    for (const auto &[key, use] : edges) {
+      Kind kind = use.count > 2   ? Kind::Locked
+                  : use.count == 1 ? Kind::Border
+                  : use.seam       ? Kind::Seam
+                                   : Kind::Manifold;
+      if (kind == Kind::Manifold)
+        continue;
+      mark(uint32_t(key >> 32), kind);
+      mark(uint32_t(key), kind);
+    }
+
+    triangleOffsets.assign(groupCount + 1, 0);
+    for (uint32_t v : indices)
+      ++triangleOffsets[group[v] + 1];
+    std::partial_sum(triangleOffsets.begin(), triangleOffsets.end(),
+                     triangleOffsets.begin());
+    triangles.resize(indices.size());
+    {
+      std::vector<uint32_t> cursor(triangleOffsets.begin(),
+                                   triangleOffsets.end() - 1);
+      for (size_t i = 0; i < indices.size(); ++i)
+        triangles[cursor[group[indices[i]]]++] = uint32_t(i / 3);
+    }
+
+    collapses.clear();
+    for (const auto &[key, use] : edges) {
+      const uint32_t a = uint32_t(key >> 32);
+      const uint32_t b = uint32_t(key);
+      Quadric q = quadrics[a];
+      q += quadrics[b];
+      Collapse best{0, 0, std::numeric_limits<double>::max()};
+      for (auto [from, to] : {std::pair{a, b}, std::pair{b, a}}) {
+        if (!canCollapse(kinds[from], kinds[to], use.seam, use.count == 1))
+          continue;
+        double cost = q.error(position(to));
+        if (cost < best.cost)
+          best = {from, to, cost};
+      }
+      if (best.cost <= limit)
+        collapses.push_back(best);
+    }
+    std::sort(collapses.begin(), collapses.end(),
+              [](const Collapse &a, const Collapse &b) {
+                return std::tie(a.cost, a.from, a.to) <
+                       std::tie(b.cost, b.from, b.to);
+              });
+
+    // At most one collapse per group and pass keeps the adjacency valid.
+    std::fill(touched.begin(), touched.end(), 0);
+    const size_t excess = triangleCount - targetIndexCount / 3;
+    size_t removed = 0;
+    for (const Collapse &collapse : collapses) {
+      if (removed >= excess)
+        break;
+      if (touched[collapse.from] || touched[collapse.to] ||
+          flips(collapse.from, collapse.to))
+        continue;
+
+      for (uint32_t i = triangleOffsets[collapse.from];
+           i < triangleOffsets[collapse.from + 1]; ++i) {
+        const size_t t = size_t(triangles[i]) * 3;
+        for (int k = 0; k < 3; ++k) {
+          if (collapseTo[group[indices[t + k]]] == collapse.to) {
+            ++removed;
+            break;
+          }
+        }
+      }
+      collapseTo[collapse.from] = collapse.to;
+      quadrics[collapse.to] += quadrics[collapse.from];
+      touched[collapse.from] = touched[collapse.to] = 1;
+    }
+    if (removed == 0)
+      break;
+
+    compact();
+    std::iota(collapseTo.begin(), collapseTo.end(), 0);
+  }
+
+  MeshBuffer result;
+  std::vector<uint32_t> remap(vertices.size(), UINT32_MAX);
+  result.indices.reserve(indices.size());
+  for (uint32_t v : indices) {
+    if (remap[v] == UINT32_MAX) {
+      remap[v] = static_cast<uint32_t>(result.vertices.size());
+      result.vertices.push_back(vertices[v]);
+    }
+    result.indices.push_back(remap[v]);
+  }
+  return result;
+}
+
+} // namespace farixEngine
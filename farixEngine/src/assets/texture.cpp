@@ -1,8 +1,10 @@
 #include "farixEngine/assets/texture.hpp"
+#include "farixEngine/math/simd.hpp"
 #include "farixEngine/thirdparty/stb_image.h"
 #include "farixEngine/utils/uuid.hpp"
 #include <SDL2/SDL.h>
 #include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <memory>
 #include <string>
@@ -28,6 +30,12 @@ std::shared_ptr<Texture> Texture::load(const std::string &filename,
   texture->texWidth = widthImg;
   texture->texHeight = heightImg;
   texture->numColCh = numColCh;
+  if (bytes) {
+    texture->hasAlpha = false;
+    for (int i = 0; i < widthImg * heightImg && !texture->hasAlpha; ++i)
+      texture->hasAlpha = bytes[i * 4 + 3] != 255;
+  }
+  texture->buildMipChain();
 
   return texture;
 }
@@ -84,4 +92,151 @@ Uint32 Texture::sample(float u, float v) const {
   return (a << 24) | (r << 16) | (g << 8) | b;
 }
 
+namespace {
+
+void storeLevel(TextureMip &mip, const std::vector<uint32_t> &linear) {
+  mip.tilesX = (mip.width + 3) / 4;
+  int tilesY = (mip.height + 3) / 4;
+  mip.texels.assign(mip.tilesX * tilesY * 16, 0);
+  for (int y = 0; y < mip.height; ++y) {
+    for (int x = 0; x < mip.width; ++x) {
+      int tile = (y >> 2) * mip.tilesX + (x >> 2);
+      int inner = (x & 1) | ((y & 1) << 1) | ((x & 2) << 1) | ((y & 2) << 2);
+      mip.texels[(tile << 4) | inner] = linear[y * mip.width + x];
+    }
+  }
+}
+
+// Bilinear blend of four ARGB8888 texels with 8-bit fixed-point weights.
+inline uint32_t bilerp(uint32_t t00, uint32_t t10, uint32_t t01, uint32_t t11,
+                       int fx, int fy) {
+#if defined(FARIX_SIMD_SSE2)
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i wx = _mm_set_epi16(fx, fx, fx, fx, 256 - fx, 256 - fx,
+                                   256 - fx, 256 - fx);
+  const __m128i wy = _mm_set_epi16(fy, fy, fy, fy, 256 - fy, 256 - fy,
+                                   256 - fy, 256 - fy);
+
+  __m128i top = _mm_unpacklo_epi8(_mm_set_epi32(0, 0, t10, t00), zero);
+  __m128i bottom = _mm_unpacklo_epi8(_mm_set_epi32(0, 0, t11, t01), zero);
+  top = _mm_mullo_epi16(top, wx);
+  bottom = _mm_mullo_epi16(bottom, wx);
+  top = _mm_srli_epi16(_mm_add_epi16(top, _mm_srli_si128(top, 8)), 8);
+  bottom = _mm_srli_epi16(_mm_add_epi16(bottom, _mm_srli_si128(bottom, 8)), 8);
+
+  __m128i rows = _mm_mullo_epi16(_mm_unpacklo_epi64(top, bottom), wy);
+  rows = _mm_srli_epi16(_mm_add_epi16(rows, _mm_srli_si128(rows, 8)), 8);
+  return static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_packus_epi16(rows, zero)));
+#else
+  uint32_t out = 0;
+  for (int shift = 0; shift < 32; shift += 8) {
+    uint32_t top = (((t00 >> shift) & 0xFF) * (256 - fx) +
+                    ((t10 >> shift) & 0xFF) * fx) >>
+                   8;
+    uint32_t bottom = (((t01 >> shift) & 0xFF) * (256 - fx) +
+                       ((t11 >> shift) & 0xFF) * fx) >>
+                      8;
+    out |= (((top * (256 - fy) + bottom * fy) >> 8) & 0xFF) << shift;
+  }
+  return out;
+#endif
+}
+
+template <typename Fetch>
+uint32_t filterBilinear(float u, float v, int width, int height,
+                        const Fetch &fetch) {
+  float fx = std::clamp(u, 0.0f, 1.0f) * width - 0.5f;
+  float fy = std::clamp(v, 0.0f, 1.0f) * height - 0.5f;
+  float floorX = std::floor(fx), floorY = std::floor(fy);
+  int wx = static_cast<int>((fx - floorX) * 256.0f);
+  int wy = static_cast<int>((fy - floorY) * 256.0f);
+
+  int x0 = std::clamp(static_cast<int>(floorX), 0, width - 1);
+  int y0 = std::clamp(static_cast<int>(floorY), 0, height - 1);
+  int x1 = std::min(x0 + 1, width - 1);
+  int y1 = std::min(y0 + 1, height - 1);
+  if (floorX < 0)
+    x1 = x0;
+  if (floorY < 0)
+    y1 = y0;
+
+  return bilerp(fetch(x0, y0), fetch(x1, y0), fetch(x0, y1), fetch(x1, y1),
+                wx, wy);
+}
+
+} // namespace
+
+void Texture::markChanged() {
+  Asset::markChanged();
+  buildMipChain();
+}
+
+void Texture::buildMipChain() {
+  mips.clear();
+  if (!texturePixels || texWidth <= 0 || texHeight <= 0)
+    return;
+
+  std::vector<uint32_t> linear(texWidth * texHeight);
+  bool anyAlpha = false;
+  for (int i = 0; i < texWidth * texHeight; ++i) {
+    const unsigned char *p = texturePixels + i * 4;
+    anyAlpha |= p[3] != 255;
+    linear[i] = (Uint32(p[3]) << 24) | (Uint32(p[0]) << 16) |
+                (Uint32(p[1]) << 8) | Uint32(p[2]);
+  }
+  hasAlpha = anyAlpha;
+
+  int width = texWidth, height = texHeight;
+  while (true) {
+    TextureMip mip;
+    mip.width = width;
+    mip.height = height;
+    storeLevel(mip, linear);
+    mips.push_back(std::move(mip));
+    if (width == 1 && height == 1)
+      break;
+
+    // 2x2 box filter; odd edges reuse the last row/column.
+    int nextWidth = std::max(1, width / 2);
+    int nextHeight = std::max(1, height / 2);
+    std::vector<uint32_t> next(nextWidth * nextHeight);
+    for (int y = 0; y < nextHeight; ++y) {
+      int y0 = std::min(y * 2, height - 1), y1 = std::min(y * 2 + 1, height - 1);
+      for (int x = 0; x < nextWidth; ++x) {
+        int x0 = std::min(x * 2, width - 1), x1 = std::min(x * 2 + 1, width - 1);
+        uint32_t t[4] = {linear[y0 * width + x0], linear[y0 * width + x1],
+                         linear[y1 * width + x0], linear[y1 * width + x1]};
+        uint32_t out = 0;
+        for (int shift = 0; shift < 32; shift += 8) {
+          uint32_t sum = ((t[0] >> shift) & 0xFF) + ((t[1] >> shift) & 0xFF) +
+                         ((t[2] >> shift) & 0xFF) + ((t[3] >> shift) & 0xFF);
+          out |= ((sum + 2) >> 2) << shift;
+        }
+        next[y * nextWidth + x] = out;
+      }
+    }
+    linear.swap(next);
+    width = nextWidth;
+    height = nextHeight;
+  }
+}
+
+Uint32 Texture::sampleBilinear(float u, float v, float lod) const {
+  if (mips.empty()) {
+    if (!texturePixels)
+      return 0xFFFFFFFF;
+    return filterBilinear(u, v, texWidth, texHeight, [&](int x, int y) {
+      const unsigned char *p = texturePixels + (y * texWidth + x) * 4;
+      return (Uint32(p[3]) << 24) | (Uint32(p[0]) << 16) |
+             (Uint32(p[1]) << 8) | Uint32(p[2]);
+    });
+  }
+
+  int level = std::clamp(static_cast<int>(lod + 0.5f), 0,
+                         static_cast<int>(mips.size()) - 1);
+  const TextureMip &mip = mips[level];
+  return filterBilinear(u, v, mip.width, mip.height,
+                        [&](int x, int y) { return mip.fetch(x, y); });
+}
+
 } // namespace farixEngine
@@ -1,6 +1,7 @@
 #include "farixEngine/core/engine.hpp"
 #include "farixEngine/core/engineContext.hpp"
 #include "farixEngine/core/engineServices.hpp"
+#include "farixEngine/renderer/headless/headlessRenderer.hpp"
 #include "farixEngine/renderer/opengl/openglRenderer.hpp"
 #include "farixEngine/renderer/software/softwareRenderer.hpp"
 #include <farixEngine/scene/sceneManager.hpp>
@@ -11,10 +12,21 @@ Engine::Engine() {}
 
 Engine::~Engine() { shutdown(); }
 
-void Engine::init(int width, int height, const char *title) {
+void Engine::init(int width, int height, const char *title,
+                  RendererBackend backend) {
   context = new EngineContext();
 
-  renderer = new renderer::OpenGLRenderer(width, height, title);
+  switch (backend) {
+  case RendererBackend::OpenGL:
+    renderer = new renderer::OpenGLRenderer(width, height, title);
+    break;
+  case RendererBackend::Software:
+    renderer = new renderer::SoftwareRenderer(width, height, title);
+    break;
+  case RendererBackend::Headless:
+    renderer = new renderer::HeadlessRenderer(width, height, title);
+    break;
+  }
   controller = new Controller();
   sceneManager = new SceneManager();
   inputManager = InputManager();
@@ -22,6 +34,11 @@ void Engine::init(int width, int height, const char *title) {
   context->renderer = renderer;
   context->sceneManager = sceneManager;
   EngineServices::get().setContext(context);
+  assetListener = EngineServices::get().getAssetManager().onAssetRemoved(
+      [this](const AssetID &id) {
+        if (renderer)
+          renderer->releaseAsset(id);
+      });
   std::cout << "Engine initialized\n";
 }
 
@@ -37,6 +54,8 @@ void Engine::endFrame() {
 
 void Engine::shutdown() {
   _running = false;
+  EngineServices::get().getAssetManager().removeListener(assetListener);
+  assetListener = 0;
   delete controller;
   controller = nullptr;
   delete renderer;
@@ -0,0 +1,306 @@
+#include "farixEngine/core/spatialIndex.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace farixEngine {
+
+namespace {
+
+bool isFinite(const BoundingSphere &sphere) {
+  return std::isfinite(sphere.center.x) && std::isfinite(sphere.center.y) &&
+         std::isfinite(sphere.center.z) && std::isfinite(sphere.radius);
+}
+
+int octantOf(const Vec3 &center, const Vec3 &point) {
+  return (point.x >= center.x ? 1 : 0) | (point.y >= center.y ? 2 : 0) |
+         (point.z >= center.z ? 4 : 0);
+}
+
+} // namespace
+
+void SpatialIndex::update(Entity e, const AABB &bounds,
+                          const BoundingSphere &sphere) {
+  if (!isFinite(sphere)) {
+    insertUnbounded(e);
+    return;
+  }
+
+  auto [it, inserted] = entries.try_emplace(e);
+  Entry &entry = it->second;
+  if (!inserted && entry.partition != Partition::Unbounded &&
+      entry.sphere.center == sphere.center &&
+      entry.sphere.radius == sphere.radius &&
+      entry.bounds.min == bounds.min && entry.bounds.max == bounds.max)
+    return;
+
+  Partition previous = inserted ? Partition::Unbounded : entry.partition;
+  if (!inserted && previous == Partition::Unbounded)
+    removeUnbounded(entry);
+  entry.bounds = bounds;
+  entry.sphere = sphere;
+
+  switch (previous) {
+  case Partition::Unbounded:
+    insertStatic(e, entry);
+    break;
+  case Partition::Static:
+    removeStatic(entry);
+    entry.lastMoved = frame;
+    insertDynamic(e, entry);
+    break;
+  case Partition::Dynamic:
+    entry.lastMoved = frame;
+    dynamicSpheres.set(entry.slot, sphere);
+    break;
+  }
+}
+
+void SpatialIndex::insertUnbounded(Entity e) {
+  auto [it, inserted] = entries.try_emplace(e);
+  Entry &entry = it->second;
+  if (!inserted) {
+    if (entry.partition == Partition::Unbounded)
+      return;
+    if (entry.partition == Partition::Static)
+      removeStatic(entry);
+    else
+      removeDynamic(entry);
+  }
+  entry.partition = Partition::Unbounded;
+  entry.node = -1;
+  entry.slot = static_cast<uint32_t>(unbounded.size());
+  unbounded.push_back(e);
+}
+
+void SpatialIndex::remove(Entity e) {
+  auto it = entries.find(e);
+  if (it == entries.end())
+    return;
+
+  switch (it->second.partition) {
+  case Partition::Static:
+    removeStatic(it->second);
+    break;
+  case Partition::Dynamic:
+    removeDynamic(it->second);
+    break;
+  case Partition::Unbounded:
+    removeUnbounded(it->second);
+    break;
+  }
+  entries.erase(it);
+}
+
+void SpatialIndex::clear() {
+  entries.clear();
+  nodes.clear();
+  root = -1;
+  dynamicEntities.clear();
+  dynamicSpheres.clear();
+  unbounded.clear();
+}
+
+void SpatialIndex::endFrame() {
+  ++frame;
+  // Walking backwards, swap-removal only moves entries that were already
+  // visited.
+  for (size_t i = dynamicEntities.size(); i-- > 0;) {
+    Entity e = dynamicEntities[i];
+    Entry &entry = entries.at(e);
+    if (frame - entry.lastMoved < kSettleFrames)
+      continue;
+    removeDynamic(entry);
+    insertStatic(e, entry);
+  }
+}
+
+void SpatialIndex::query(const Frustum &frustum,
+                         std::vector<Entity> &out) const {
+  if (root >= 0)
+    queryNode(root, frustum, false, out);
+
+  frustum.cullSpheres(dynamicSpheres, visibleScratch);
+  for (size_t i = 0; i < dynamicEntities.size(); ++i) {
+    if (visibleScratch[i])
+      out.push_back(dynamicEntities[i]);
+  }
+
+  out.insert(out.end(), unbounded.begin(), unbounded.end());
+}
+
+void SpatialIndex::insertStatic(Entity e, Entry &entry) {
+  const BoundingSphere &sphere = entry.sphere;
+  if (root < 0) {
+    Node node;
+    node.center = sphere.center;
+    node.halfSize = std::max(kMinRootHalfSize, sphere.radius);
+    nodes.push_back(std::move(node));
+    root = 0;
+  }
+  growRoot(sphere);
+
+  // A loose node holds anything centered in its cell that is no larger than
+  // the cell, so descend while the child cell still covers the radius.
+  int32_t node = root;
+  while (nodes[node].split && nodes[node].halfSize * 0.5f >= sphere.radius)
+    node = childFor(node, sphere.center);
+  addToNode(node, e, entry);
+
+  if (!nodes[node].split && nodes[node].entities.size() > kSplitThreshold &&
+      nodes[node].halfSize * 0.5f >= kMinHalfSize)
+    splitNode(node);
+}
+
+void SpatialIndex::addToNode(int32_t node, Entity e, Entry &entry) {
+  Node &target = nodes[node];
+  entry.partition = Partition::Static;
+  entry.node = node;
+  entry.slot = static_cast<uint32_t>(target.entities.size());
+  target.entities.push_back(e);
+  target.spheres.push(entry.sphere);
+  for (int32_t n = node; n >= 0; n = nodes[n].parent)
+    ++nodes[n].subtreeCount;
+}
+
+void SpatialIndex::splitNode(int32_t node) {
+  nodes[node].split = true;
+  const float childHalfSize = nodes[node].halfSize * 0.5f;
+
+  // Walking backwards, swap-removal only moves entities that were already
+  // visited.
+  for (size_t i = nodes[node].entities.size(); i-- > 0;) {
+    Entity e = nodes[node].entities[i];
+    Entry &entry = entries.at(e);
+    if (entry.sphere.radius > childHalfSize)
+      continue;
+    removeStatic(entry);
+    addToNode(childFor(node, entry.sphere.center), e, entry);
+  }
+
+  // Splitting a child appends nodes, so re-read the child list every time.
+  for (int octant = 0; octant < 8; ++octant) {
+    int32_t child = nodes[node].children[octant];
+    if (child >= 0 && nodes[child].entities.size() > kSplitThreshold &&
+        nodes[child].halfSize * 0.5f >= kMinHalfSize)
+      splitNode(child);
+  }
+}
+
+void SpatialIndex::removeStatic(Entry &entry) {
+  Node &node = nodes[entry.node];
+  Entity moved = node.entities.back();
+  node.entities[entry.slot] = moved;
+  node.entities.pop_back();
+  node.spheres.swapRemove(entry.slot);
+  if (entry.slot < node.entities.size())
+    entries.at(moved).slot = entry.slot;
+
+  for (int32_t n = entry.node; n >= 0; n = nodes[n].parent)
+    --nodes[n].subtreeCount;
+  entry.node = -1;
+}
+
+void SpatialIndex::insertDynamic(Entity e, Entry &entry) {
+  entry.partition = Partition::Dynamic;
+  entry.node = -1;
+  entry.slot = static_cast<uint32_t>(dynamicEntities.size());
+  dynamicEntities.push_back(e);
+  dynamicSpheres.push(entry.sphere);
+}
+
+void SpatialIndex::removeDynamic(Entry &entry) {
+  Entity moved = dynamicEntities.back();
+  dynamicEntities[entry.slot] = moved;
+  dynamicEntities.pop_back();
+  dynamicSpheres.swapRemove(entry.slot);
+  if (entry.slot < dynamicEntities.size())
+    entries.at(moved).slot = entry.slot;
+}
+
+void SpatialIndex::removeUnbounded(Entry &entry) {
+  Entity moved = unbounded.back();
+  unbounded[entry.slot] = moved;
+  unbounded.pop_back();
+  if (entry.slot < unbounded.size())
+    entries.at(moved).slot = entry.slot;
+}
+
+void SpatialIndex::growRoot(const BoundingSphere &sphere) {
+  while (true) {
+    const Node &current = nodes[root];
+    Vec3 d = sphere.center - current.center;
+    float h = current.halfSize;
+    if (std::abs(d.x) <= h && std::abs(d.y) <= h && std::abs(d.z) <= h &&
+        sphere.radius <= h)
+      return;
+
+    // Double the root towards the sphere; the old root becomes the octant
+    // of the new one on the opposite side.
+    Node grown;
+    grown.halfSize = 2.0f * h;
+    grown.center = current.center + Vec3(d.x < 0 ? -h : h, d.y < 0 ? -h : h,
+                                         d.z < 0 ? -h : h);
+    grown.children[octantOf(grown.center, current.center)] = root;
+    grown.split = true;
+    grown.subtreeCount = current.subtreeCount;
+    nodes.push_back(std::move(grown));
+
+    int32_t newRoot = static_cast<int32_t>(nodes.size() - 1);
+    nodes[root].parent = newRoot;
+    root = newRoot;
+  }
+}
+
+int32_t SpatialIndex::childFor(int32_t node, const Vec3 &point) {
+  int octant = octantOf(nodes[node].center, point);
+  if (nodes[node].children[octant] >= 0)
+    return nodes[node].children[octant];
+
+  float h = nodes[node].halfSize * 0.5f;
+  Node child;
+  child.halfSize = h;
+  child.center = nodes[node].center + Vec3(octant & 1 ? h : -h,
+                                           octant & 2 ? h : -h,
+                                           octant & 4 ? h : -h);
+  child.parent = node;
+  nodes.push_back(std::move(child));
+
+  int32_t index = static_cast<int32_t>(nodes.size() - 1);
+  nodes[node].children[octant] = index;
+  return index;
+}
+
+void SpatialIndex::queryNode(int32_t node, const Frustum &frustum,
+                             bool inside, std::vector<Entity> &out) const {
+  const Node &n = nodes[node];
+  if (!n.subtreeCount)
+    return;
+
+  if (!inside) {
+    // Loose bounds: twice the cell size.
+    AABB loose;
+    loose.min = n.center - Vec3(2.0f * n.halfSize);
+    loose.max = n.center + Vec3(2.0f * n.halfSize);
+    Containment containment = frustum.classify(loose);
+    if (containment == Containment::Outside)
+      return;
+    inside = containment == Containment::Inside;
+  }
+
+  if (inside) {
+    out.insert(out.end(), n.entities.begin(), n.entities.end());
+  } else {
+    frustum.cullSpheres(n.spheres, visibleScratch);
+    for (size_t i = 0; i < n.entities.size(); ++i) {
+      if (visibleScratch[i])
+        out.push_back(n.entities[i]);
+    }
+  }
+
+  for (int32_t child : n.children) {
+    if (child >= 0)
+      queryNode(child, frustum, inside, out);
+  }
+}
+
+} // namespace farixEngine
@@ -0,0 +1,342 @@
+#include "farixEngine/core/staticBatches.hpp"
+#include "farixEngine/assets/material.hpp"
+#include "farixEngine/assets/mesh.hpp"
+#include "farixEngine/assets/texture.hpp"
+#include "farixEngine/core/engineServices.hpp"
+#include "farixEngine/core/world.hpp"
+#include "farixEngine/renderer/renderData.hpp"
+#include "farixEngine/utils/uuid.hpp"
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <tuple>
+
+namespace farixEngine {
+
+namespace {
+
+bool sameMatrix(const Mat4 &a, const Mat4 &b) {
+  for (int col = 0; col < 4; ++col)
+    for (int row = 0; row < 4; ++row)
+      if (a[col][row] != b[col][row])
+        return false;
+  return true;
+}
+
+bool hasOverrides(const MaterialComponent &material) {
+  return material.overrideParams && material.overrides != MaterialOverrides{};
+}
+
+bool isOpaque(const Material &material) {
+  if (material.blendMode != BlendMode::Alpha)
+    return material.blendMode == BlendMode::Opaque;
+  if (material.useTexture) {
+    auto texture = EngineServices::get().getAssetManager().get<Texture>(
+        material.texture);
+    if (texture)
+      return !texture->hasAlpha;
+  }
+  return material.baseColor.w >= 1.0f;
+}
+
+// World matrix of e multiplied out from the root down, as HierarchySystem
+// does, so the result is bit-identical to the GlobalTransform it computes.
+// Fails when e or an ancestor may move.
+bool staticWorldMatrix(World &world, StaticBatches::Entity e, Mat4 &out) {
+  std::vector<StaticBatches::Entity> chain;
+  for (StaticBatches::Entity node = e;;) {
+    if (!world.hasComponent<TransformComponent>(node) ||
+        world.hasComponent<RigidBodyComponent>(node) ||
+        world.hasComponent<BillboardComponent>(node))
+      return false;
+    chain.push_back(node);
+    if (!world.hasComponent<ParentComponent>(node))
+      break;
+    node = world.getComponent<ParentComponent>(node).parent;
+  }
+
+  out = Mat4::identity();
+  for (auto it = chain.rbegin(); it != chain.rend(); ++it)
+    out = out * Mat4::modelMatrix(world.getComponent<TransformComponent>(*it));
+  return true;
+}
+
+struct Candidate {
+  StaticBatches::Entity entity;
+  Mat4 worldMatrix;
+  const Mesh *mesh;
+  AABB bounds;
+};
+
+} // namespace
+
+void StaticBatches::clear() {
+  for (Batch &batch : batches)
+    retire(batch);
+  batches.clear();
+  members.clear();
+  moved.clear();
+  dirty.clear();
+}
+
+std::vector<std::string> StaticBatches::takeRetiredMeshes() {
+  std::vector<std::string> out;
+  out.swap(retiredMeshes);
+  return out;
+}
+
+StaticBatches::Cell StaticBatches::cellFor(const AABB &bounds) const {
+  Vec3 center = bounds.center() * (1.0f / clusterSize);
+  return {int(std::floor(center.x)), int(std::floor(center.y)),
+          int(std::floor(center.z))};
+}
+
+void StaticBatches::retire(Batch &batch) {
+  if (batch.mesh)
+    retiredMeshes.push_back(batch.mesh->uuid);
+  batch.mesh.reset();
+}
+
+void StaticBatches::build(World &world, float clusterSize) {
+  SpatialIndex &index = world.getSpatialIndex();
+  for (const auto &[entity, member] : members) {
+    if (!world.hasComponent<GlobalTransform>(entity))
+      continue;
+    const auto &global = world.getComponent<GlobalTransform>(entity);
+    if (global.hasBounds)
+      index.update(entity, global.worldBounds, global.worldSphere);
+  }
+  for (Batch &batch : batches)
+    retire(batch);
+  batches.clear();
+  members.clear();
+  dirty.clear();
+
+  this->clusterSize = clusterSize;
+  merge(world, nullptr);
+}
+
+void StaticBatches::update(World &world) {
+  for (auto it = moved.begin(); it != moved.end();) {
+    const Entity e = it->first;
+    if (!world.hasComponent<GlobalTransform>(e)) {
+      it = moved.erase(it);
+      continue;
+    }
+    const auto &global = world.getComponent<GlobalTransform>(e);
+    Moved &entry = it->second;
+    if (!sameMatrix(entry.worldMatrix, global.worldMatrix)) {
+      entry.worldMatrix = global.worldMatrix;
+      entry.stillFrames = 0;
+      ++it;
+      continue;
+    }
+    if (++entry.stillFrames < kSettleFrames) {
+      ++it;
+      continue;
+    }
+    if (global.hasBounds && world.hasComponent<MaterialComponent>(e))
+      dirty.insert({world.getComponent<MaterialComponent>(e).material,
+                    cellFor(global.worldBounds)});
+    it = moved.erase(it);
+  }
+
+  if (!dirty.empty()) {
+    // Dirty cells are merged whole, so settled entities join the members
+    // that stayed.
+    for (Batch &batch : batches) {
+      if (!batch.dissolved && dirty.count({batch.material, batch.cell}))
+        dissolve(world, batch, 0);
+    }
+    merge(world, &dirty);
+    dirty.clear();
+  }
+  compact();
+}
+
+void StaticBatches::merge(World &world, const std::set<CellKey> *only) {
+  auto &am = EngineServices::get().getAssetManager();
+  SpatialIndex &index = world.getSpatialIndex();
+
+  // Ordered maps keep the batch layout independent of hashing.
+  std::map<AssetID, std::map<Cell, std::vector<Candidate>>> groups;
+  for (Entity e : world.getEntities()) {
+    if (members.count(e) || moved.count(e) ||
+        !world.hasComponent<GlobalTransform>(e) ||
+        !world.hasComponent<MeshComponent>(e) ||
+        !world.hasComponent<MaterialComponent>(e))
+      continue;
+    const auto &meshC = world.getComponent<MeshComponent>(e);
+    const auto &matC = world.getComponent<MaterialComponent>(e);
+    if (meshC.mesh.empty() || matC.material.empty() || hasOverrides(matC))
+      continue;
+
+    auto mesh = am.get<Mesh>(meshC.mesh);
+    auto material = am.get<Material>(matC.material);
+    if (!mesh || mesh->indices().empty() || !material || !isOpaque(*material))
+      continue;
+
+    Candidate candidate{e, Mat4(), mesh.get(), AABB()};
+    if (!staticWorldMatrix(world, e, candidate.worldMatrix))
+      continue;
+    candidate.bounds = mesh->bounds.transformed(candidate.worldMatrix);
+
+    Cell cell = cellFor(candidate.bounds);
+    if (only && !only->count({matC.material, cell}))
+      continue;
+    groups[matC.material][cell].push_back(candidate);
+  }
+
+  auto emit = [&](const AssetID &material, const Cell &cell,
+                  const std::vector<const Candidate *> &run) {
+    auto buffer = std::make_shared<MeshBuffer>();
+    Batch batch;
+    batch.material = material;
+    batch.cell = cell;
+    batch.bounds = run.front()->bounds;
+
+    for (const Candidate *c : run) {
+      const Mat4 &m = c->worldMatrix;
+      Mat4 normalMatrix = m.inverse().transpose();
+      float det = m[0][0] * (m[1][1] * m[2][2] - m[2][1] * m[1][2]) -
+                  m[1][0] * (m[0][1] * m[2][2] - m[2][1] * m[0][2]) +
+                  m[2][0] * (m[0][1] * m[1][2] - m[1][1] * m[0][2]);
+
+      const uint32_t base = static_cast<uint32_t>(buffer->vertices.size());
+      for (const Vertex &v : c->mesh->vertices()) {
+        Vertex out;
+        out.position = (m * Vec4(v.position, 1.0f)).xyz();
+        out.normal = (normalMatrix * Vec4(v.normal, 0.0f)).xyz().normalized();
+        out.uv = v.uv;
+        buffer->vertices.push_back(out);
+      }
+      // Mirroring transforms flip the winding; restore counter-clockwise.
+      const auto &indices = c->mesh->indices();
+      for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+        buffer->indices.push_back(base + indices[i]);
+        buffer->indices.push_back(base + indices[det < 0.0f ? i + 2 : i + 1]);
+        buffer->indices.push_back(base + indices[det < 0.0f ? i + 1 : i + 2]);
+      }
+
+      batch.bounds.expand(c->bounds.min);
+      batch.bounds.expand(c->bounds.max);
+      batch.members.push_back(c->entity);
+      members[c->entity] = {static_cast<uint32_t>(batches.size()),
+                            c->worldMatrix, c->mesh, c->mesh->version};
+
+      auto &global = world.getComponent<GlobalTransform>(c->entity);
+      global.worldMatrix = c->worldMatrix;
+      global.worldBounds = c->bounds;
+      global.worldSphere = c->mesh->boundingSphere.transformed(c->worldMatrix);
+      global.hasBounds = true;
+      index.remove(c->entity);
+    }
+
+    batch.sphere.center = batch.bounds.center();
+    batch.sphere.radius = batch.bounds.extents().length();
+    batch.mesh = std::make_shared<renderer::MeshData>();
+    batch.mesh->uuid = utils::generateUUID();
+    batch.mesh->buffer = std::move(buffer);
+    batches.push_back(std::move(batch));
+  };
+
+  std::vector<const Candidate *> run;
+  for (const auto &[material, cells] : groups) {
+    for (const auto &[cell, candidates] : cells) {
+      // A lone mesh gains nothing from merging.
+      if (candidates.size() < 2)
+        continue;
+      run.clear();
+      size_t vertices = 0;
+      for (const Candidate &c : candidates) {
+        size_t count = c.mesh->vertices().size();
+        if (!run.empty() && vertices + count > kMaxBatchVertices) {
+          if (run.size() > 1)
+            emit(material, cell, run);
+          run.clear();
+          vertices = 0;
+        }
+        run.push_back(&c);
+        vertices += count;
+      }
+      if (run.size() > 1)
+        emit(material, cell, run);
+    }
+  }
+}
+
+bool StaticBatches::matches(World &world, Entity e,
+                            const Mat4 &worldMatrix) const {
+  auto it = members.find(e);
+  if (it == members.end())
+    return false;
+  const Member &member = it->second;
+  if (!sameMatrix(member.worldMatrix, worldMatrix) ||
+      !world.hasComponent<MeshComponent>(e) ||
+      !world.hasComponent<MaterialComponent>(e))
+    return false;
+
+  const auto &matC = world.getComponent<MaterialComponent>(e);
+  if (matC.material != batches[member.batch].material || hasOverrides(matC))
+    return false;
+
+  auto mesh = EngineServices::get().getAssetManager().get<Mesh>(
+      world.getComponent<MeshComponent>(e).mesh);
+  return mesh.get() == member.mesh && mesh->version == member.meshVersion;
+}
+
+void StaticBatches::release(World &world, Entity e) {
+  auto it = members.find(e);
+  if (it == members.end())
+    return;
+  Batch &batch = batches[it->second.batch];
+  moved[e] = {it->second.worldMatrix, 0};
+  dirty.insert({batch.material, batch.cell});
+  members.erase(it);
+  dissolve(world, batch, e);
+}
+
+void StaticBatches::dissolve(World &world, Batch &batch, Entity skip) {
+  SpatialIndex &index = world.getSpatialIndex();
+  for (Entity member : batch.members) {
+    members.erase(member);
+    if (member == skip || !world.hasComponent<GlobalTransform>(member))
+      continue;
+    const auto &global = world.getComponent<GlobalTransform>(member);
+    if (global.hasBounds)
+      index.update(member, global.worldBounds, global.worldSphere);
+  }
+  batch.members.clear();
+  retire(batch);
+  batch.dissolved = true;
+}
+
+void StaticBatches::compact() {
+  std::vector<uint32_t> remap(batches.size());
+  uint32_t kept = 0;
+  for (uint32_t i = 0; i < batches.size(); ++i) {
+    if (batches[i].dissolved)
+      continue;
+    remap[i] = kept;
+    if (i != kept)
+      batches[kept] = std::move(batches[i]);
+    ++kept;
+  }
+  if (kept == batches.size())
+    return;
+  batches.erase(batches.begin() + kept, batches.end());
+  for (auto &[entity, member] : members)
+    member.batch = remap[member.batch];
+}
+
+void StaticBatches::query(const Frustum &frustum,
+                          std::vector<uint32_t> &out) const {
+  for (uint32_t i = 0; i < batches.size(); ++i) {
+    const Batch &batch = batches[i];
+    if (!batch.dissolved && frustum.intersects(batch.sphere) &&
+        frustum.intersects(batch.bounds))
+      out.push_back(i);
+  }
+}
+
+} // namespace farixEngine
@@ -23,10 +23,16 @@ const std::vector<Entity> &World::getEntities() const { return entities; }
 void World::clearStorages() {
   componentManager.clearStorages();
   entities.clear();
+  spatialIndex.clear();
+  staticBatches.clear();
   _nextEntity = 1;
   _cameraE = 0;
 }
 
+void World::buildStaticBatches(float clusterSize) {
+  staticBatches.build(*this, clusterSize);
+}
+
 void World::setCameraEntity(Entity c) { _cameraE = c; }
 
 World::Entity World::getCamera() const { return _cameraE; }
@@ -176,11 +182,13 @@ std::vector<World::Entity> World::getChildren(Entity parent) const {
 ComponentManager &World::getComponentManager() { return componentManager; }
 
 void World::destroyEntity(Entity e) {
+  staticBatches.release(*this, e);
   removeParent(e);
   removeAllChildren(e);
   for (auto &[type, storagePtr] : componentManager.getStorages()) {
     storagePtr->remove(e);
   }
+  spatialIndex.remove(e);
 
   entities.erase(std::remove(entities.begin(), entities.end(), e),
                  entities.end());
@@ -0,0 +1,188 @@
+#include "farixEngine/math/bounds.hpp"
+#include "farixEngine/math/simd.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace farixEngine {
+
+void AABB::expand(const Vec3 &point) {
+  min = Vec3(std::min(min.x, point.x), std::min(min.y, point.y),
+             std::min(min.z, point.z));
+  max = Vec3(std::max(max.x, point.x), std::max(max.y, point.y),
+             std::max(max.z, point.z));
+}
+
+AABB AABB::transformed(const Mat4 &m) const {
+  Vec3 c = center();
+  Vec3 e = extents();
+  Vec3 newCenter = (m * Vec4(c, 1.0f)).xyz();
+  Vec3 newExtents;
+  for (int row = 0; row < 3; ++row)
+    newExtents[row] = std::abs(m[0][row]) * e.x + std::abs(m[1][row]) * e.y +
+                      std::abs(m[2][row]) * e.z;
+
+  AABB box;
+  box.min = newCenter - newExtents;
+  box.max = newCenter + newExtents;
+  return box;
+}
+
+BoundingSphere BoundingSphere::transformed(const Mat4 &m) const {
+  float scaleSq = 0.0f;
+  for (int col = 0; col < 3; ++col)
+    scaleSq = std::max(scaleSq, m[col][0] * m[col][0] +
+                                    m[col][1] * m[col][1] +
+                                    m[col][2] * m[col][2]);
+
+  BoundingSphere sphere;
+  sphere.center = (m * Vec4(center, 1.0f)).xyz();
+  sphere.radius = radius * std::sqrt(scaleSq);
+  return sphere;
+}
+
+void SphereBatch::clear() {
+  x.clear();
+  y.clear();
+  z.clear();
+  radius.clear();
+}
+
+void SphereBatch::push(const BoundingSphere &sphere) {
+  x.push_back(sphere.center.x);
+  y.push_back(sphere.center.y);
+  z.push_back(sphere.center.z);
+  radius.push_back(sphere.radius);
+}
+
+void SphereBatch::set(size_t index, const BoundingSphere &sphere) {
+  x[index] = sphere.center.x;
+  y[index] = sphere.center.y;
+  z[index] = sphere.center.z;
+  radius[index] = sphere.radius;
+}
+
+void SphereBatch::swapRemove(size_t index) {
+  x[index] = x.back();
+  y[index] = y.back();
+  z[index] = z.back();
+  radius[index] = radius.back();
+  x.pop_back();
+  y.pop_back();
+  z.pop_back();
+  radius.pop_back();
+}
+
+Frustum Frustum::fromMatrix(const Mat4 &viewProjection) {
+  Vec4 r0 = viewProjection.getRow(0);
+  Vec4 r1 = viewProjection.getRow(1);
+  Vec4 r2 = viewProjection.getRow(2);
+  Vec4 r3 = viewProjection.getRow(3);
+
+  // Gribb-Hartmann: -w <= x, y, z <= w in clip space. Vec4 arithmetic resets
+  // w, so the planes are summed component-wise.
+  auto combine = [](const Vec4 &a, const Vec4 &b, float sign) {
+    return Vec4(a.x + sign * b.x, a.y + sign * b.y, a.z + sign * b.z,
+                a.w + sign * b.w);
+  };
+
+  Frustum frustum;
+  frustum.planes[0] = combine(r3, r0, 1.0f);
+  frustum.planes[1] = combine(r3, r0, -1.0f);
+  frustum.planes[2] = combine(r3, r1, 1.0f);
+  frustum.planes[3] = combine(r3, r1, -1.0f);
+  frustum.planes[4] = combine(r3, r2, 1.0f);
+  frustum.planes[5] = combine(r3, r2, -1.0f);
+  for (Vec4 &p : frustum.planes) {
+    float length = std::sqrt(p.x * p.x + p.y * p.y + p.z * p.z);
+    if (length > 0.0f)
+      p = Vec4(p.x / length, p.y / length, p.z / length, p.w / length);
+  }
+  return frustum;
+}
+
+bool Frustum::intersects(const BoundingSphere &sphere) const {
+  for (const Vec4 &p : planes) {
+    if (p.x * sphere.center.x + p.y * sphere.center.y +
+            p.z * sphere.center.z + p.w <
+        -sphere.radius)
+      return false;
+  }
+  return true;
+}
+
+bool Frustum::intersects(const AABB &box) const {
+  return classify(box) != Containment::Outside;
+}
+
+Containment Frustum::classify(const AABB &box) const {
+  Vec3 c = box.center();
+  Vec3 e = box.extents();
+  Containment result = Containment::Inside;
+  for (const Vec4 &p : planes) {
+    float distance = p.x * c.x + p.y * c.y + p.z * c.z + p.w;
+    float reach =
+        std::abs(p.x) * e.x + std::abs(p.y) * e.y + std::abs(p.z) * e.z;
+    if (distance < -reach)
+      return Containment::Outside;
+    if (distance < reach)
+      result = Containment::Intersects;
+  }
+  return result;
+}
+
+void Frustum::cullSpheres(const SphereBatch &spheres,
+                          std::vector<uint8_t> &visible) const {
+  const size_t count = spheres.size();
+  visible.resize(count);
+  size_t i = 0;
+
+#if defined(FARIX_SIMD_AVX2)
+  for (; i + 8 <= count; i += 8) {
+    __m256 x = _mm256_loadu_ps(spheres.x.data() + i);
+    __m256 y = _mm256_loadu_ps(spheres.y.data() + i);
+    __m256 z = _mm256_loadu_ps(spheres.z.data() + i);
+    __m256 r = _mm256_loadu_ps(spheres.radius.data() + i);
+    __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+    for (const Vec4 &p : planes) {
+      __m256 d = _mm256_add_ps(
+          _mm256_add_ps(_mm256_mul_ps(x, _mm256_set1_ps(p.x)),
+                        _mm256_mul_ps(y, _mm256_set1_ps(p.y))),
+          _mm256_add_ps(_mm256_mul_ps(z, _mm256_set1_ps(p.z)),
+                        _mm256_add_ps(r, _mm256_set1_ps(p.w))));
+      inside = _mm256_and_ps(
+          inside, _mm256_cmp_ps(d, _mm256_setzero_ps(), _CMP_GE_OQ));
+    }
+    int mask = _mm256_movemask_ps(inside);
+    for (int lane = 0; lane < 8; ++lane)
+      visible[i + lane] = (mask >> lane) & 1;
+  }
+#endif
+#if defined(FARIX_SIMD_SSE2)
+  for (; i + 4 <= count; i += 4) {
+    __m128 x = _mm_loadu_ps(spheres.x.data() + i);
+    __m128 y = _mm_loadu_ps(spheres.y.data() + i);
+    __m128 z = _mm_loadu_ps(spheres.z.data() + i);
+    __m128 r = _mm_loadu_ps(spheres.radius.data() + i);
+    __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+    for (const Vec4 &p : planes) {
+      __m128 d = _mm_add_ps(
+          _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(p.x)),
+                     _mm_mul_ps(y, _mm_set1_ps(p.y))),
+          _mm_add_ps(_mm_mul_ps(z, _mm_set1_ps(p.z)),
+                     _mm_add_ps(r, _mm_set1_ps(p.w))));
+      inside = _mm_and_ps(inside, _mm_cmpge_ps(d, _mm_setzero_ps()));
+    }
+    int mask = _mm_movemask_ps(inside);
+    for (int lane = 0; lane < 4; ++lane)
+      visible[i + lane] = (mask >> lane) & 1;
+  }
+#endif
+  for (; i < count; ++i) {
+    BoundingSphere sphere;
+    sphere.center = Vec3(spheres.x[i], spheres.y[i], spheres.z[i]);
+    sphere.radius = spheres.radius[i];
+    visible[i] = intersects(sphere) ? 1 : 0;
+  }
+}
+
+} // namespace farixEngine
@@ -0,0 +1,62 @@
+#include "farixEngine/renderer/drawKey.hpp"
+#include <algorithm>
+#include <array>
+
+namespace farixEngine::renderer {
+
+uint64_t DrawKey::make(uint32_t pass, bool translucent, float depth,
+                       uint32_t shader, uint32_t material, uint32_t mesh) {
+  constexpr uint32_t depthMax = (1u << kDepthBits) - 1;
+  float d = depth > 0.0f ? std::min(depth, 1.0f) : 0.0f;
+  uint32_t bucket = static_cast<uint32_t>(d * depthMax);
+  if (translucent)
+    bucket = depthMax - bucket;
+  else
+    bucket &= ~((1u << (kDepthBits - kOpaqueDepthBits)) - 1);
+
+  uint64_t key = std::min(pass, (1u << kPassBits) - 1);
+  key = (key << 1) | (translucent ? 1 : 0);
+  key = (key << kDepthBits) | bucket;
+  key = (key << kShaderBits) | (shader & ((1u << kShaderBits) - 1));
+  key = (key << kMaterialBits) | (material & ((1u << kMaterialBits) - 1));
+  key = (key << kMeshBits) | (mesh & ((1u << kMeshBits) - 1));
+  return key;
+}
+
+void radixSortKeys(const std::vector<uint64_t> &keys,
+                   std::vector<uint32_t> &order,
+                   std::vector<uint32_t> &scratch) {
+  const size_t count = keys.size();
+  order.resize(count);
+  scratch.resize(count);
+  for (uint32_t i = 0; i < count; ++i)
+    order[i] = i;
+  if (count < 2)
+    return;
+
+  // All eight histograms in one sweep.
+  std::array<std::array<uint32_t, 256>, 8> histograms{};
+  for (uint64_t key : keys) {
+    for (int byte = 0; byte < 8; ++byte)
+      ++histograms[byte][(key >> (byte * 8)) & 0xFF];
+  }
+
+  for (int byte = 0; byte < 8; ++byte) {
+    auto &histogram = histograms[byte];
+    const int shift = byte * 8;
+    if (histogram[(keys[0] >> shift) & 0xFF] == count)
+      continue;
+
+    uint32_t offset = 0;
+    for (uint32_t &bucket : histogram) {
+      uint32_t n = bucket;
+      bucket = offset;
+      offset += n;
+    }
+    for (uint32_t index : order)
+      scratch[histogram[(keys[index] >> shift) & 0xFF]++] = index;
+    order.swap(scratch);
+  }
+}
+
+} // namespace farixEngine::renderer
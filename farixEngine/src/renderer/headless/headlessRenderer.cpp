@@ -0,0 +1,204 @@
+#include "farixEngine/renderer/headless/headlessRenderer.hpp"
+#include <SDL2/SDL.h>
+#include <SDL_ttf.h>
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <iostream>
+
+namespace farixEngine::renderer {
+
+namespace {
+
+uint32_t crc32(const uint8_t *data, size_t size, uint32_t crc = 0) {
+  static const std::array<uint32_t, 256> table = [] {
+    std::array<uint32_t, 256> t{};
+    for (uint32_t n = 0; n < 256; ++n) {
+      uint32_t c = n;
+      for (int k = 0; k < 8; ++k)
+        c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+      t[n] = c;
+    }
+    return t;
+  }();
+
+  crc = ~crc;
+  for (size_t i = 0; i < size; ++i)
+    crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+  return ~crc;
+}
+
+void putU32BE(std::vector<uint8_t> &out, uint32_t v) {
+  out.push_back(v >> 24);
+  out.push_back(v >> 16);
+  out.push_back(v >> 8);
+  out.push_back(v);
+}
+
+void writeChunk(std::ofstream &file, const char *type,
+                const std::vector<uint8_t> &data) {
+  std::vector<uint8_t> chunk;
+  putU32BE(chunk, static_cast<uint32_t>(data.size()));
+  chunk.insert(chunk.end(), type, type + 4);
+  chunk.insert(chunk.end(), data.begin(), data.end());
+  putU32BE(chunk, crc32(chunk.data() + 4, chunk.size() - 4));
+  file.write(reinterpret_cast<const char *>(chunk.data()), chunk.size());
+}
+
+// zlib stream made of uncompressed deflate blocks; keeps the writer free of
+// external dependencies at the cost of file size.
+std::vector<uint8_t> zlibStore(const std::vector<uint8_t> &raw) {
+  std::vector<uint8_t> out = {0x78, 0x01};
+  size_t offset = 0;
+  do {
+    size_t len = std::min<size_t>(raw.size() - offset, 0xFFFF);
+    bool last = offset + len == raw.size();
+    out.push_back(last ? 1 : 0);
+    out.push_back(len & 0xFF);
+    out.push_back(len >> 8);
+    out.push_back(~len & 0xFF);
+    out.push_back((~len >> 8) & 0xFF);
+    out.insert(out.end(), raw.begin() + offset, raw.begin() + offset + len);
+    offset += len;
+  } while (offset < raw.size());
+
+  uint32_t a = 1, b = 0;
+  for (uint8_t byte : raw) {
+    a = (a + byte) % 65521;
+    b = (b + a) % 65521;
+  }
+  putU32BE(out, (b << 16) | a);
+  return out;
+}
+
+} // namespace
+
+HeadlessRenderer::HeadlessRenderer(int width, int height,
+                                   [[maybe_unused]] const char *title)
+    : SoftwareRenderer(width, height) {
+  if (!TTF_WasInit() && TTF_Init() == -1) {
+    std::cerr << "Failed to initialize SDL_ttf: " << TTF_GetError()
+              << std::endl;
+  }
+}
+
+HeadlessRenderer::~HeadlessRenderer() {
+  // Join the render thread while this object is still fully constructed.
+  setPipelined(false);
+}
+
+void HeadlessRenderer::present() {
+  flushTextDraws();
+  ++frameCount;
+}
+
+void HeadlessRenderer::renderText(const UITextDrawCommand &cmd) {
+  if (!cmd.font || !cmd.font->sdlFont)
+    return;
+
+  SDL_Color sdlColor = {static_cast<Uint8>(cmd.color.x * 255),
+                        static_cast<Uint8>(cmd.color.y * 255),
+                        static_cast<Uint8>(cmd.color.z * 255),
+                        static_cast<Uint8>(cmd.color.w * 255)};
+
+  SDL_Surface *srf =
+      TTF_RenderUTF8_Blended(cmd.font->sdlFont, cmd.text.c_str(), sdlColor);
+  if (!srf) {
+    std::cerr << "Failed to render text surface: " << TTF_GetError()
+              << std::endl;
+    return;
+  }
+  SDL_Surface *argb = SDL_ConvertSurfaceFormat(srf, SDL_PIXELFORMAT_ARGB8888, 0);
+  SDL_FreeSurface(srf);
+  if (!argb)
+    return;
+
+  int originX = static_cast<int>(cmd.pos.x);
+  int originY = static_cast<int>(cmd.pos.y);
+  for (int y = 0; y < argb->h; ++y) {
+    int dy = originY + y;
+    if (dy < 0 || dy >= screenHeight)
+      continue;
+    const uint32_t *row = reinterpret_cast<const uint32_t *>(
+        static_cast<uint8_t *>(argb->pixels) + y * argb->pitch);
+    for (int x = 0; x < argb->w; ++x) {
+      int dx = originX + x;
+      if (dx < 0 || dx >= screenWidth)
+        continue;
+      Vec4 src = unpackColor(row[x]);
+      Vec4 dst = unpackColor(framebuffer[dy * screenWidth + dx]);
+      Vec4 out = src * src.w + dst * (1.0f - src.w);
+      out.w = src.w + dst.w * (1.0f - src.w);
+      framebuffer[dy * screenWidth + dx] = packColor(out);
+    }
+  }
+  SDL_FreeSurface(argb);
+}
+
+uint32_t HeadlessRenderer::readPixel(int x, int y) const {
+  if (x < 0 || x >= screenWidth || y < 0 || y >= screenHeight)
+    return 0;
+  return framebuffer[y * screenWidth + x];
+}
+
+std::vector<uint32_t> HeadlessRenderer::readPixels() const {
+  return std::vector<uint32_t>(framebuffer,
+                               framebuffer + screenWidth * screenHeight);
+}
+
+bool HeadlessRenderer::savePPM(const std::string &path) const {
+  std::ofstream file(path, std::ios::binary);
+  if (!file.is_open()) {
+    std::cerr << "Failed to open " << path << " for writing\n";
+    return false;
+  }
+
+  file << "P6\n" << screenWidth << " " << screenHeight << "\n255\n";
+  std::vector<uint8_t> row(screenWidth * 3);
+  for (int y = 0; y < screenHeight; ++y) {
+    for (int x = 0; x < screenWidth; ++x) {
+      uint32_t c = framebuffer[y * screenWidth + x];
+      row[x * 3 + 0] = (c >> 16) & 0xFF;
+      row[x * 3 + 1] = (c >> 8) & 0xFF;
+      row[x * 3 + 2] = c & 0xFF;
+    }
+    file.write(reinterpret_cast<const char *>(row.data()), row.size());
+  }
+  return file.good();
+}
+
+bool HeadlessRenderer::savePNG(const std::string &path) const {
+  std::ofstream file(path, std::ios::binary);
+  if (!file.is_open()) {
+    std::cerr << "Failed to open " << path << " for writing\n";
+    return false;
+  }
+
+  std::vector<uint8_t> raw;
+  raw.reserve((screenWidth * 4 + 1) * screenHeight);
+  for (int y = 0; y < screenHeight; ++y) {
+    raw.push_back(0);
+    for (int x = 0; x < screenWidth; ++x) {
+      uint32_t c = framebuffer[y * screenWidth + x];
+      raw.push_back((c >> 16) & 0xFF);
+      raw.push_back((c >> 8) & 0xFF);
+      raw.push_back(c & 0xFF);
+      raw.push_back((c >> 24) & 0xFF);
+    }
+  }
+
+  static const uint8_t signature[8] = {0x89, 'P',  'N',  'G',
+                                       '\r', '\n', 0x1A, '\n'};
+  file.write(reinterpret_cast<const char *>(signature), sizeof(signature));
+
+  std::vector<uint8_t> header;
+  putU32BE(header, screenWidth);
+  putU32BE(header, screenHeight);
+  header.insert(header.end(), {8, 6, 0, 0, 0});
+  writeChunk(file, "IHDR", header);
+  writeChunk(file, "IDAT", zlibStore(raw));
+  writeChunk(file, "IEND", {});
+  return file.good();
+}
+
+} // namespace farixEngine::renderer
@@ -0,0 +1,83 @@
+#include "farixEngine/renderer/instanceBatcher.hpp"
+#include <functional>
+
+namespace farixEngine::renderer {
+
+bool InstanceKey::operator==(const InstanceKey &other) const {
+  return mesh == other.mesh && texture == other.texture &&
+         blendMode == other.blendMode && useTexture == other.useTexture &&
+         ambient == other.ambient && diffuse == other.diffuse &&
+         specular == other.specular && shininess == other.shininess;
+}
+
+size_t InstanceBatcher::KeyHash::operator()(const InstanceKey &key) const {
+  size_t h = std::hash<const void *>()(key.mesh);
+  h ^= std::hash<const void *>()(key.texture) + 0x9e3779b9 + (h << 6) +
+       (h >> 2);
+  h ^= static_cast<size_t>(key.blendMode) + 0x9e3779b9 + (h << 6) + (h >> 2);
+  return h;
+}
+
+void InstanceBatcher::clear() {
+  groups.clear();
+  pending.clear();
+  unorderedGroups.clear();
+  lastGroup = -1;
+}
+
+void InstanceBatcher::add(uint32_t command, const InstanceKey &key,
+                          const Mat4 &model, const Vec4 &color, bool ordered) {
+  int32_t group = -1;
+  if (ordered) {
+    if (lastGroup >= 0 && lastGroup == static_cast<int32_t>(groups.size()) - 1 &&
+        groups[lastGroup].ordered && groups[lastGroup].key == key)
+      group = lastGroup;
+  } else if (lastGroup >= 0 && !groups[lastGroup].ordered &&
+             groups[lastGroup].key == key) {
+    // Sorted passes submit equal keys back to back.
+    group = lastGroup;
+  } else if (auto it = unorderedGroups.find(key); it != unorderedGroups.end()) {
+    group = static_cast<int32_t>(it->second);
+  }
+
+  if (group < 0) {
+    group = static_cast<int32_t>(groups.size());
+    groups.push_back({key, command, 0, ordered});
+    if (!ordered)
+      unorderedGroups.emplace(key, static_cast<uint32_t>(group));
+  }
+
+  ++groups[group].count;
+  pending.push_back({static_cast<uint32_t>(group), {model, color}});
+  lastGroup = group;
+}
+
+void InstanceBatcher::flush(InstanceBackend &backend) {
+  if (pending.empty()) {
+    clear();
+    return;
+  }
+
+  cursors.resize(groups.size());
+  uint32_t offset = 0;
+  for (size_t g = 0; g < groups.size(); ++g) {
+    cursors[g] = offset;
+    offset += groups[g].count;
+  }
+
+  packed.resize(pending.size());
+  for (const PendingInstance &instance : pending)
+    packed[cursors[instance.group]++] = instance.data;
+  backend.uploadInstances(packed);
+
+  for (size_t g = 0; g < groups.size(); ++g) {
+    InstanceBatch batch;
+    batch.command = groups[g].command;
+    batch.instanceCount = groups[g].count;
+    batch.firstInstance = cursors[g] - groups[g].count;
+    backend.drawInstanced(batch);
+  }
+  clear();
+}
+
+} // namespace farixEngine::renderer
@@ -0,0 +1,25 @@
+#include "farixEngine/renderer/opengl/UBO.hpp"
+
+namespace farixEngine::renderer {
+
+UBO::UBO(GLsizeiptr size) {
+  glGenBuffers(1, &ID);
+  glBindBuffer(GL_UNIFORM_BUFFER, ID);
+  glBufferData(GL_UNIFORM_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
+  glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+void UBO::Update(const void *data, GLsizeiptr size) {
+  glBindBuffer(GL_UNIFORM_BUFFER, ID);
+  glBufferData(GL_UNIFORM_BUFFER, size, data, GL_DYNAMIC_DRAW);
+  glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+void UBO::BindBase(GLuint binding) {
+  glBindBufferBase(GL_UNIFORM_BUFFER, binding, ID);
+}
+void UBO::BindRange(GLuint binding, GLintptr offset, GLsizeiptr size) {
+  glBindBufferRange(GL_UNIFORM_BUFFER, binding, ID, offset, size);
+}
+void UBO::Delete() { glDeleteBuffers(1, &ID); }
+} // namespace farixEngine::renderer
@@ -2,7 +2,7 @@
 
 namespace farixEngine::renderer {
 
-VBO::VBO(GLfloat *vertices, GLsizeiptr size) {
+VBO::VBO(const GLfloat *vertices, GLsizeiptr size) {
   glGenBuffers(1, &ID);
   glBindBuffer(GL_ARRAY_BUFFER, ID);
   glBufferData(GL_ARRAY_BUFFER, size, vertices, GL_STATIC_DRAW);
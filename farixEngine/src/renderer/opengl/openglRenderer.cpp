@@ -1,12 +1,55 @@
 #include "farixEngine/renderer/opengl/openglRenderer.hpp"
 #include "farixEngine/AssetConfig.h"
+#include "farixEngine/renderer/drawKey.hpp"
 #include "farixEngine/renderer/opengl/shader.hpp"
 #include "farixEngine/renderer/renderData.hpp"
 #include "farixEngine/renderer/renderer.hpp"
 
+#include <algorithm>
 #include <array>
+#include <cstring>
 namespace farixEngine::renderer {
 
+static_assert(sizeof(PassUniforms) == 112 &&
+                  offsetof(PassUniforms, camPos) == 96 &&
+                  offsetof(PassUniforms, enableLight) == 108,
+              "PassUniforms must match the std140 PassBlock");
+static_assert(sizeof(MaterialUniforms) == 32 &&
+                  offsetof(MaterialUniforms, useTexture) == 16,
+              "MaterialUniforms must match the std140 MaterialBlock");
+
+namespace {
+
+// Base color travels with the instance data, not the material block.
+bool sameMaterialUniforms(const GPUMaterialData &a, const GPUMaterialData &b) {
+  return a.useTexture == b.useTexture &&
+         a.ambient == b.ambient && a.diffuse == b.diffuse &&
+         a.specular == b.specular && a.shininess == b.shininess;
+}
+
+template <typename Material>
+MaterialUniforms materialUniforms(const Material &material) {
+  MaterialUniforms uniforms;
+  uniforms.ambient = material.ambient;
+  uniforms.diffuse = material.diffuse;
+  uniforms.specular = material.specular;
+  uniforms.shininess = material.shininess;
+  uniforms.useTexture = material.useTexture ? 1 : 0;
+  return uniforms;
+}
+
+size_t meshBytes(const MeshData &mesh) {
+  return mesh.vertices().size() * sizeof(VertexData) +
+         mesh.indices().size() * sizeof(uint32_t);
+}
+
+// RGBA8 with a full mip chain.
+size_t textureBytes(int width, int height) {
+  return size_t(width) * height * 4 * 4 / 3;
+}
+
+} // namespace
+
 OpenGLRenderer::OpenGLRenderer(int width, int height, const char *title)
     : IRenderer(width, height, title) {
   if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_EVENTS | SDL_INIT_TIMER) != 0) {
@@ -58,6 +101,19 @@ OpenGLRenderer::OpenGLRenderer(int width, int height, const char *title)
       Shader(std::string(FARIX_ASSET_DIR) + "/shaders/text.vert",
              std::string(FARIX_ASSET_DIR) + "/shaders/text.frag");
 
+  spriteShaderProgram =
+      Shader(std::string(FARIX_ASSET_DIR) + "/shaders/sprite.vert",
+             std::string(FARIX_ASSET_DIR) + "/shaders/sprite.frag");
+
+  GLint uniformAlignment = 0;
+  glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &uniformAlignment);
+  if (uniformAlignment > 0)
+    materialStride = (sizeof(MaterialUniforms) + uniformAlignment - 1) /
+                     uniformAlignment * uniformAlignment;
+  passUniformBuffer = UBO(sizeof(PassUniforms));
+  passUniformBuffer.BindBase(kPassBlockBinding);
+  materialUniformBuffer = UBO(materialStride);
+
   glEnable(GL_DEPTH_TEST);
   glDepthFunc(GL_LESS);
   glEnable(GL_BLEND);
@@ -65,6 +121,15 @@ OpenGLRenderer::OpenGLRenderer(int width, int height, const char *title)
   glEnable(GL_CULL_FACE);
   glCullFace(GL_BACK);
   glFrontFace(GL_CCW);
+
+  gpuMeshCache.setReleaseCallback(
+      [this](const std::string &, std::shared_ptr<GPUMesh> &mesh) {
+        retiredMeshes.push_back(std::move(mesh));
+      });
+  gpuTextureCache.setReleaseCallback(
+      [this](const std::string &, std::shared_ptr<Texture> &texture) {
+        retiredTextures.push_back(std::move(texture));
+      });
 }
 
 OpenGLRenderer::~OpenGLRenderer() { SDL_DestroyWindow(window); }
@@ -74,6 +139,52 @@ void OpenGLRenderer::beginFrame() {
   passes.clear();
   activePass = nullptr;
   currentContext = nullptr;
+  releaseRetired();
+}
+
+void OpenGLRenderer::releaseRetired() {
+  auto unused = [](const auto &object) { return object.use_count() == 1; };
+  for (auto &mesh : retiredMeshes) {
+    if (!unused(mesh))
+      continue;
+    instancedVaos.erase(mesh->vao.ID);
+    mesh->vao.Delete();
+    mesh->vbo.Delete();
+    mesh->ebo.Delete();
+    mesh.reset();
+  }
+  retiredMeshes.erase(
+      std::remove(retiredMeshes.begin(), retiredMeshes.end(), nullptr),
+      retiredMeshes.end());
+
+  for (auto &texture : retiredTextures) {
+    if (!unused(texture))
+      continue;
+    texture->Delete();
+    texture.reset();
+  }
+  retiredTextures.erase(
+      std::remove(retiredTextures.begin(), retiredTextures.end(), nullptr),
+      retiredTextures.end());
+}
+
+void OpenGLRenderer::releaseAsset(const std::string &id) {
+  gpuMeshCache.erase(id);
+  const std::string lodPrefix = id + "#lod";
+  gpuMeshCache.eraseIf([&](const std::string &key, const auto &) {
+    return key.compare(0, lodPrefix.size(), lodPrefix) == 0;
+  });
+  gpuTextureCache.erase(id);
+  if (auto it = glyphTextures.find(id); it != glyphTextures.end()) {
+    if (it->second.texture)
+      retiredTextures.push_back(std::move(it->second.texture));
+    glyphTextures.erase(it);
+  }
+}
+
+void OpenGLRenderer::setCacheBudgets(size_t meshBytes, size_t textureBytes) {
+  gpuMeshCache.setBudget(meshBytes);
+  gpuTextureCache.setBudget(textureBytes);
 }
 void OpenGLRenderer::beginPass(RenderContext &renderContext) {
   RenderPass rp;
@@ -105,13 +216,13 @@ void OpenGLRenderer::endFrame() {
     } else {
       glEnable(GL_CULL_FACE);
     }
+    uploadPassUniforms(pass.context);
 
     for (auto &mesh : pass.meshCommands) {
       renderMesh(mesh);
     }
-    for (auto &mesh : pass.gpuMeshCommands) {
-      renderMesh(mesh);
-    }
+    drawMeshCommands(pass);
+    drawSpriteCommands(pass);
     for (auto &text : pass.textCommands) {
       renderText(text);
     }
@@ -144,27 +255,29 @@ void OpenGLRenderer::submitMesh(const std::shared_ptr<MeshData> mesh,
   gpuMaterial.uuid = material.uuid;
   gpuMaterial.uvMax = material.uvMax;
   gpuMaterial.uvMin = material.uvMin;
+  gpuMaterial.blendMode = material.resolvedBlendMode();
   GPUMeshCommand meshCommand{gpuMesh, gpuMaterial, model};
+  meshCommand.sortKey = sortKeyFor(meshCommand);
   activePass->gpuMeshCommands.push_back(meshCommand);
 }
 
 void OpenGLRenderer::submitSprite(const SpriteData &sprite, const Mat4 &model) {
-  std::shared_ptr<MeshData> quadMesh = quadMesh2D();
-
-  Mat4 scaleMat = Mat4::scale(Vec3(sprite.size[0], sprite.size[1], 1.0f));
-  Mat4 finalMat = model * scaleMat;
-
-  auto gpuMesh = createOrGetGPUMesh(quadMesh);
-  auto gpuTexture = createOrGetGPUTexture(sprite.texture);
-  GPUMaterialData mat;
-  mat.useTexture = sprite.useTexture;
-  mat.texture = gpuTexture;
-  mat.baseColor = sprite.color;
-  mat.doubleSided = true;
-  mat.uvMin = sprite.uvMin;
-  mat.uvMax = sprite.uvMax;
-  GPUMeshCommand meshCommand{gpuMesh, mat, model};
-  activePass->gpuMeshCommands.push_back(meshCommand);
+  SpriteCommand command;
+  if (sprite.useTexture)
+    command.texture = createOrGetGPUTexture(sprite.texture);
+  command.modelMatrix =
+      model * Mat4::scale(Vec3(sprite.size[0], sprite.size[1], 1.0f));
+  command.uvMin = sprite.uvMin;
+  command.uvMax = sprite.uvMax;
+  if (sprite.flipX)
+    std::swap(command.uvMin.x, command.uvMax.x);
+  if (sprite.flipY)
+    std::swap(command.uvMin.y, command.uvMax.y);
+  // Textured sprites show the texture as is; the sprite shader tints
+  // textures by the vertex color.
+  command.color =
+      sprite.useTexture ? Vec4(1.0f, 1.0f, 1.0f, 1.0f) : sprite.color;
+  activePass->spriteCommands.push_back(command);
 }
 
 void OpenGLRenderer::submitText2D(Font *font, const std::string &str, Vec3 pos,
@@ -175,183 +288,407 @@ void OpenGLRenderer::submitText2D(Font *font, const std::string &str, Vec3 pos,
 
 void OpenGLRenderer::submitText(Font *font, const std::string &str, Vec3 pos,
                                 float size, Vec4 color, Mat4 model) {
-  SDL_Color sdlColor = {(Uint8)(color.x * 255), (Uint8)(color.y * 255),
-                        (Uint8)(color.z * 255), (Uint8)(color.w * 255)};
-
-  std::string cacheKey =
-      str + "_" + font->id + "_" + std::to_string(sdlColor.r) + "_" +
-      std::to_string(sdlColor.g) + "_" + std::to_string(sdlColor.b) + "_" +
-      std::to_string(sdlColor.a);
-
-  std::shared_ptr<Texture> textTex;
+  if (!font || !font->sdlFont || str.empty())
+    return;
 
-  if (auto it = gpuTextureCache.find(cacheKey); it != gpuTextureCache.end()) {
-    textTex = it->second;
-  } else {
-    SDL_Surface *srf =
-        TTF_RenderUTF8_Blended(font->sdlFont, str.c_str(), sdlColor);
-    if (!srf) {
-      std::cerr << "TTF_RenderUTF8_Blended failed: " << TTF_GetError() << "\n";
-      return;
+  GlyphAtlas &atlas = font->glyphAtlas();
+  glyphQuads.clear();
+  atlas.layout(str, glyphQuads);
+  if (glyphQuads.empty())
+    return;
+  std::shared_ptr<Texture> atlasTexture = glyphTexture(*font);
+
+  // Each glyph quad is the unit square scaled to its extent and moved to its
+  // center, folded straight into the model columns.
+  const Vec4 axisX = model.getCol(0);
+  const Vec4 axisY = model.getCol(1);
+  const Vec4 origin = model.getCol(3);
+  for (const GlyphQuad &quad : glyphQuads) {
+    float cx = (quad.min.x + quad.max.x) * 0.5f;
+    float cy = (quad.min.y + quad.max.y) * 0.5f;
+    float ex = quad.max.x - quad.min.x;
+    float ey = quad.max.y - quad.min.y;
+
+    SpriteCommand command;
+    command.texture = atlasTexture;
+    command.modelMatrix = model;
+    for (int row = 0; row < 4; ++row) {
+      command.modelMatrix[0][row] = axisX[row] * ex;
+      command.modelMatrix[1][row] = axisY[row] * ey;
+      command.modelMatrix[3][row] =
+          origin[row] + axisX[row] * cx + axisY[row] * cy;
     }
+    command.uvMin = quad.uvMin;
+    command.uvMax = quad.uvMax;
+    command.color = color;
+    activePass->spriteCommands.push_back(command);
+  }
+}
 
-    SDL_Surface *rgba =
-        SDL_ConvertSurfaceFormat(srf, SDL_PIXELFORMAT_RGBA32, 0);
-    SDL_FreeSurface(srf);
-    if (!rgba) {
-      std::cerr << "SDL_ConvertSurfaceFormat failed\n";
-      return;
-    }
+std::shared_ptr<Texture> OpenGLRenderer::glyphTexture(Font &font) {
+  GlyphAtlas &atlas = font.glyphAtlas();
+  GlyphTexture &entry = glyphTextures[font.id];
+  if (entry.texture && entry.version == atlas.version())
+    return entry.texture;
+
+  ::farixEngine::Texture pixels;
+  pixels.texWidth = atlas.width();
+  pixels.texHeight = atlas.height();
+  pixels.texturePixels = const_cast<unsigned char *>(atlas.pixels().data());
+  // New glyphs were packed since the last upload. Sprites queued earlier in
+  // the pass still reference this texture, so update it in place.
+  if (entry.texture)
+    entry.texture->update(&pixels, GL_RGBA, GL_UNSIGNED_BYTE);
+  else
+    entry.texture = std::make_shared<Texture>(&pixels, GL_TEXTURE_2D, 0,
+                                              GL_RGBA, GL_UNSIGNED_BYTE);
+  // The atlas keeps ownership of its pixels.
+  pixels.texturePixels = nullptr;
+  entry.version = atlas.version();
+  return entry.texture;
+}
 
-    const int w = rgba->w, h = rgba->h;
+uint64_t OpenGLRenderer::sortKeyFor(const GPUMeshCommand &command) const {
+  const RenderContext &ctx = activePass->context;
+  // Distance of the object's origin along the view direction, normalized
+  // over the clip range.
+  float viewZ = -ctx.viewMatrix.getRow(2).dot(command.modelMatrix.getCol(3));
+  float depth = (viewZ - ctx.nearPlane) / (ctx.farPlane - ctx.nearPlane);
+
+  const GPUMaterialData &material = command.gpuMatData;
+  bool translucent = material.blendMode != BlendMode::Opaque;
+  GLuint texture = material.texture ? material.texture->ID : 0;
+  return DrawKey::make(static_cast<uint32_t>(passes.size() - 1), translucent,
+                       depth, defaultShaderProgram.ID, texture,
+                       command.gpuMesh->vao.ID);
+}
 
-    unsigned char *tight = (unsigned char *)malloc(w * h * 4);
-    if (!tight) {
-      SDL_FreeSurface(rgba);
-      std::cerr << "malloc failed\n";
-      return;
-    }
-    for (int y = 0; y < h; ++y) {
-      memcpy(tight + y * w * 4, (unsigned char *)rgba->pixels + y * rgba->pitch,
-             w * 4);
-    }
-    SDL_FreeSurface(rgba);
+void OpenGLRenderer::drawMeshCommands(const RenderPass &pass) {
+  const auto &commands = pass.gpuMeshCommands;
+  if (commands.empty())
+    return;
 
-    ::farixEngine::Texture tempTex;
-    tempTex.texWidth = w;
-    tempTex.texHeight = h;
-    tempTex.texturePixels = tight;
+  // Without depth testing, submission order is the layering order.
+  const bool depthTested = pass.context.enableZBuffer && !pass.context.is2DPass;
+  if (depthTested) {
+    sortKeys.resize(commands.size());
+    for (size_t i = 0; i < commands.size(); ++i)
+      sortKeys[i] = commands[i].sortKey;
+    radixSortKeys(sortKeys, drawOrder, sortScratch);
+  } else {
+    drawOrder.resize(commands.size());
+    for (uint32_t i = 0; i < commands.size(); ++i)
+      drawOrder[i] = i;
+  }
 
-    textTex = std::make_shared<Texture>(&tempTex, GL_TEXTURE_2D, 1, GL_RGBA,
-                                        GL_UNSIGNED_BYTE);
+  // Sorted passes keep equal materials together, so only changes between
+  // neighbours get a new slot.
+  materialTable.clear();
+  commandMaterials.resize(commands.size());
+  const GPUMaterialData *previousMaterial = nullptr;
+  uint32_t materialSlot = 0;
+
+  for (uint32_t index : drawOrder) {
+    const GPUMeshCommand &command = commands[index];
+    const GPUMaterialData &material = command.gpuMatData;
+    if (!previousMaterial || !sameMaterialUniforms(*previousMaterial, material))
+      materialSlot = packMaterial(materialUniforms(material));
+    previousMaterial = &material;
+    commandMaterials[index] = materialSlot;
+
+    InstanceKey key;
+    key.mesh = command.gpuMesh.get();
+    key.texture = material.texture.get();
+    key.blendMode = material.blendMode;
+    key.useTexture = material.useTexture;
+    key.ambient = material.ambient;
+    key.diffuse = material.diffuse;
+    key.specular = material.specular;
+    key.shininess = material.shininess;
+    bool ordered = !depthTested || material.blendMode != BlendMode::Opaque;
+    instanceBatcher.add(index, key, command.modelMatrix, material.baseColor,
+                        ordered);
+  }
 
-    // free(tight);
+  uploadMaterials();
+  batchCommands = &commands;
+  resetBoundState();
+  instanceBatcher.flush(*this);
+  batchCommands = nullptr;
 
-    gpuTextureCache.emplace(cacheKey, textTex);
+  glBindVertexArray(0);
+  if (bound.texture) {
+    glActiveTexture(GL_TEXTURE0 + bound.textureUnit);
+    glBindTexture(GL_TEXTURE_2D, 0);
   }
+  resetBoundState();
+}
 
-  std::shared_ptr<GPUMesh> quadMesh;
-  const std::string meshKey = "textQuad_" + cacheKey;
-  if (auto it = gpuMeshCache.find(meshKey); it != gpuMeshCache.end()) {
-    quadMesh = it->second;
-  } else {
-    // const float w = (float)textTex->width;
-    // const float h = (float)textTex->height;
-    const float aspectRatio = (float)textTex->width / (float)textTex->height;
-    const float w = aspectRatio / 2;
-    const float h = 0.5f;
+void OpenGLRenderer::resetBoundState() { bound = BoundState(); }
 
-    MeshData mesh;
-    mesh.vertices.resize(4);
-    mesh.indices = {0, 1, 2, 2, 3, 0};
+void OpenGLRenderer::uploadPassUniforms(const RenderContext &context) {
+  PassUniforms uniforms;
+  uniforms.camMatrix = context.projectionMatrix * context.viewMatrix;
+  uniforms.lightColor = context.lightColor;
+  uniforms.lightPos = context.lightPos;
+  uniforms.camPos = context.cameraPosition;
+  uniforms.enableLight = context.enableLighting ? 1 : 0;
+  passUniformBuffer.Update(&uniforms, sizeof(uniforms));
+}
 
-    for (int i = 0; i < 4; ++i)
-      mesh.vertices[i].normal = {0.0f, 0.0f, 1.0f};
+uint32_t OpenGLRenderer::packMaterial(const MaterialUniforms &material) {
+  size_t offset = materialTable.size();
+  materialTable.resize(offset + materialStride);
+  std::memcpy(materialTable.data() + offset, &material, sizeof(material));
+  return static_cast<uint32_t>(offset / materialStride);
+}
 
-    mesh.vertices[0].position = {-w, -h, 0.0f};
+void OpenGLRenderer::uploadMaterials() {
+  materialUniformBuffer.Update(materialTable.data(), materialTable.size());
+}
 
-    mesh.vertices[1].position = {w, -h, 0.0f};
+void OpenGLRenderer::uploadInstances(
+    const std::vector<InstanceData> &instances) {
+  if (!instanceBuffer)
+    glGenBuffers(1, &instanceBuffer);
+  glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+  // Respecifying the store orphans the one the previous pass may still be
+  // reading.
+  glBufferData(GL_ARRAY_BUFFER, instances.size() * sizeof(InstanceData),
+               instances.data(), GL_STREAM_DRAW);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
 
-    mesh.vertices[2].position = {w, h, 0.0f};
+void OpenGLRenderer::drawInstanced(const InstanceBatch &batch) {
+  const GPUMeshCommand &command = (*batchCommands)[batch.command];
+  bindDrawState(command, commandMaterials[batch.command]);
+  setInstanced(true);
+
+  // The instance stream lives in the VAO, so each mesh links it once; the
+  // buffer name stays the same when its store is respecified.
+  GLuint vao = command.gpuMesh->vao.ID;
+  if (instancedVaos.insert(vao).second) {
+    glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+    for (GLuint column = 0; column < 4; ++column) {
+      GLuint location = 3 + column;
+      glVertexAttribPointer(
+          location, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+          (void *)(offsetof(InstanceData, model) + column * sizeof(Vec4)));
+      glEnableVertexAttribArray(location);
+      glVertexAttribDivisor(location, 1);
+    }
+    glVertexAttribPointer(7, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+                          (void *)offsetof(InstanceData, color));
+    glEnableVertexAttribArray(7);
+    glVertexAttribDivisor(7, 1);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+  }
 
-    mesh.vertices[3].position = {-w, h, 0.0f};
+  glDrawElementsInstancedBaseInstance(
+      GL_TRIANGLES, static_cast<GLsizei>(command.gpuMesh->indexCount),
+      GL_UNSIGNED_INT, 0, batch.instanceCount, batch.firstInstance);
+}
 
-    mesh.vertices[0].uv = {0.0f, 1.0f};
-    mesh.vertices[1].uv = {1.0f, 1.0f};
-    mesh.vertices[2].uv = {1.0f, 0.0f};
-    mesh.vertices[3].uv = {0.0f, 0.0f};
+void OpenGLRenderer::drawSpriteCommands(const RenderPass &pass) {
+  const auto &commands = pass.spriteCommands;
+  if (commands.empty())
+    return;
 
-    quadMesh = std::make_shared<GPUMesh>(mesh);
-    gpuMeshCache.emplace(meshKey, quadMesh);
+  for (uint32_t i = 0; i < commands.size(); ++i) {
+    const SpriteCommand &command = commands[i];
+    spriteBatcher.add(i, command.modelMatrix, command.uvMin, command.uvMax,
+                      command.color, command.texture.get(),
+                      command.blendMode);
   }
-  GPUMaterialData mat;
-  mat.baseColor = color;
-  mat.doubleSided = true;
-  mat.texture = textTex;
-  mat.useTexture = true;
 
-  GPUMeshCommand meshCommand{quadMesh, mat, model};
-  activePass->gpuMeshCommands.push_back(meshCommand);
+  spriteShaderProgram.Activate();
+  spriteShaderProgram.setInt("tex0", 0);
+  spriteCommands = &commands;
+  spriteBatcher.flush(*this);
+  spriteCommands = nullptr;
+
+  glBindVertexArray(0);
+  glActiveTexture(GL_TEXTURE0);
+  glBindTexture(GL_TEXTURE_2D, 0);
+  resetBoundState();
 }
 
-void OpenGLRenderer::renderMesh(const GPUMeshCommand &meshCommand) {
+void OpenGLRenderer::uploadSpriteVertices(
+    const std::vector<SpriteVertex> &vertices) {
+  if (!spriteVao) {
+    glGenVertexArrays(1, &spriteVao);
+    glGenBuffers(1, &spriteVertexBuffer);
+    glGenBuffers(1, &spriteIndexBuffer);
+
+    glBindVertexArray(spriteVao);
+    glBindBuffer(GL_ARRAY_BUFFER, spriteVertexBuffer);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(SpriteVertex),
+                          (void *)offsetof(SpriteVertex, position));
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(SpriteVertex),
+                          (void *)offsetof(SpriteVertex, uv));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(SpriteVertex),
+                          (void *)offsetof(SpriteVertex, color));
+    glEnableVertexAttribArray(2);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, spriteIndexBuffer);
+  }
+  glBindVertexArray(spriteVao);
+
+  // Every quad uses the same six indices, so the index buffer only changes
+  // when the largest pass so far grows.
+  const size_t quads = vertices.size() / 4;
+  if (quads > spriteQuadCapacity) {
+    spriteQuadCapacity = std::max<size_t>(quads, 2 * spriteQuadCapacity);
+    std::vector<uint32_t> indices(spriteQuadCapacity * 6);
+    for (uint32_t q = 0; q < spriteQuadCapacity; ++q) {
+      const uint32_t v = q * 4;
+      const uint32_t quad[6] = {v, v + 1, v + 2, v + 2, v + 3, v};
+      std::copy(quad, quad + 6, indices.begin() + q * 6);
+    }
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(uint32_t),
+                 indices.data(), GL_STATIC_DRAW);
+  }
 
-  auto gpuMesh = meshCommand.gpuMesh;
+  // Respecifying the store orphans the one the previous pass may still be
+  // reading.
+  glBindBuffer(GL_ARRAY_BUFFER, spriteVertexBuffer);
+  glBufferData(GL_ARRAY_BUFFER, spriteQuadCapacity * 4 * sizeof(SpriteVertex),
+               nullptr, GL_STREAM_DRAW);
+  glBufferSubData(GL_ARRAY_BUFFER, 0, vertices.size() * sizeof(SpriteVertex),
+                  vertices.data());
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
 
-  std::shared_ptr<renderer::Texture> gpuTex = meshCommand.gpuMatData.texture;
+void OpenGLRenderer::drawSprites(const SpriteBatch &batch) {
+  const SpriteCommand &command = (*spriteCommands)[batch.command];
+  spriteShaderProgram.setBool("useTexture", command.texture != nullptr);
+  if (command.texture) {
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, command.texture->ID);
+  }
+  applyBlendMode(batch.blendMode);
 
-  defaultShaderProgram.Activate();
+  glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(batch.quadCount * 6),
+                 GL_UNSIGNED_INT,
+                 (void *)(size_t(batch.firstQuad) * 6 * sizeof(uint32_t)));
+}
 
-  defaultShaderProgram.setMat4("model", meshCommand.modelMatrix);
-  defaultShaderProgram.setMat4("camMatrix", currentContext->projectionMatrix *
-                                                currentContext->viewMatrix);
+void OpenGLRenderer::setInstanced(bool instanced) {
+  int value = instanced ? 1 : 0;
+  if (bound.instanced == value)
+    return;
+  defaultShaderProgram.setBool("instanced", instanced);
+  bound.instanced = value;
+}
 
-  defaultShaderProgram.setVec4("objectColor", meshCommand.gpuMatData.baseColor);
-  defaultShaderProgram.setBool("useTexture", meshCommand.gpuMatData.useTexture);
+void OpenGLRenderer::bindDrawState(const GPUMeshCommand &meshCommand,
+                                   uint32_t materialSlot) {
+  const std::shared_ptr<renderer::Texture> &gpuTex =
+      meshCommand.gpuMatData.texture;
 
-  defaultShaderProgram.setBool("enableLight", currentContext->enableLighting);
+  if (bound.program != defaultShaderProgram.ID) {
+    defaultShaderProgram.Activate();
+    bound.program = defaultShaderProgram.ID;
+    bound.samplerUnit = ~0u;
+    bound.instanced = -1;
+  }
 
-  defaultShaderProgram.setVec4("lightColor", currentContext->lightColor);
-  defaultShaderProgram.setVec3("lightPos", currentContext->lightPos);
-  defaultShaderProgram.setVec3("camPos", currentContext->cameraPosition);
-  defaultShaderProgram.setFloat("matAmbient", meshCommand.gpuMatData.ambient);
-  defaultShaderProgram.setFloat("matDiffuse", meshCommand.gpuMatData.diffuse);
-  defaultShaderProgram.setFloat("matSpecular", meshCommand.gpuMatData.specular);
-  defaultShaderProgram.setFloat("matShininess",
-                                meshCommand.gpuMatData.shininess);
+  if (materialSlot != bound.materialSlot) {
+    materialUniformBuffer.BindRange(kMaterialBlockBinding,
+                                    materialSlot * materialStride,
+                                    sizeof(MaterialUniforms));
+    bound.materialSlot = materialSlot;
+  }
 
   if (gpuTex) {
-    gpuTex->Bind();
-    gpuTex->texUnit(defaultShaderProgram, "tex0", gpuTex->unit);
+    if (gpuTex->ID != bound.texture || gpuTex->unit != bound.textureUnit) {
+      gpuTex->Bind();
+      bound.texture = gpuTex->ID;
+      bound.textureUnit = gpuTex->unit;
+    }
+    if (gpuTex->unit != bound.samplerUnit) {
+      defaultShaderProgram.setInt("tex0", static_cast<int>(gpuTex->unit));
+      bound.samplerUnit = gpuTex->unit;
+    }
   }
 
-  gpuMesh->vao.Bind();
+  applyBlendMode(meshCommand.gpuMatData.blendMode);
 
-  glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(gpuMesh->indexCount),
+  if (meshCommand.gpuMesh->vao.ID != bound.vao) {
+    glBindVertexArray(meshCommand.gpuMesh->vao.ID);
+    bound.vao = meshCommand.gpuMesh->vao.ID;
+  }
+}
+
+void OpenGLRenderer::renderMesh(const GPUMeshCommand &meshCommand) {
+  materialTable.clear();
+  packMaterial(materialUniforms(meshCommand.gpuMatData));
+  uploadMaterials();
+
+  resetBoundState();
+  bindDrawState(meshCommand, 0);
+  setInstanced(false);
+  defaultShaderProgram.setMat4("model", meshCommand.modelMatrix);
+  defaultShaderProgram.setVec4("objectColor", meshCommand.gpuMatData.baseColor);
+
+  glDrawElements(GL_TRIANGLES,
+                 static_cast<GLsizei>(meshCommand.gpuMesh->indexCount),
                  GL_UNSIGNED_INT, 0);
+  glBindVertexArray(0);
+  resetBoundState();
+}
 
-  gpuMesh->vao.Unbind();
-  if (gpuTex)
-    gpuTex->unBind();
+void OpenGLRenderer::applyBlendMode(BlendMode mode) {
+  if (mode == currentBlendMode)
+    return;
+  currentBlendMode = mode;
+
+  switch (mode) {
+  case BlendMode::Opaque:
+    glDisable(GL_BLEND);
+    break;
+  case BlendMode::Alpha:
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    break;
+  case BlendMode::Additive:
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+    break;
+  }
 }
 
 void OpenGLRenderer::renderMesh(const MeshCommand &meshCommand) {
-  auto gpuMeshIt = gpuMeshCache.find(meshCommand.meshData->uuid);
-  if (gpuMeshIt == gpuMeshCache.end())
+  auto *cachedMesh = gpuMeshCache.find(meshCommand.meshData->uuid);
+  if (!cachedMesh)
     return;
-  auto gpuMesh = gpuMeshIt->second;
+  auto gpuMesh = *cachedMesh;
 
   std::shared_ptr<Texture> gpuTex = nullptr;
   if (meshCommand.matData.useTexture && meshCommand.matData.texture) {
-    auto texIt = gpuTextureCache.find(meshCommand.matData.texture->id);
-    if (texIt != gpuTextureCache.end())
-      gpuTex = texIt->second;
+    if (auto *cachedTex = gpuTextureCache.find(meshCommand.matData.texture->id))
+      gpuTex = *cachedTex;
   }
 
-  defaultShaderProgram.Activate();
+  materialTable.clear();
+  packMaterial(materialUniforms(meshCommand.matData));
+  uploadMaterials();
+  materialUniformBuffer.BindRange(kMaterialBlockBinding, 0,
+                                  sizeof(MaterialUniforms));
 
+  defaultShaderProgram.Activate();
+  defaultShaderProgram.setBool("instanced", false);
   defaultShaderProgram.setMat4("model", meshCommand.modelMatrix);
-  defaultShaderProgram.setMat4("camMatrix", currentContext->projectionMatrix *
-                                                currentContext->viewMatrix);
-
   defaultShaderProgram.setVec4("objectColor", meshCommand.matData.baseColor);
-  defaultShaderProgram.setBool("useTexture", meshCommand.matData.useTexture);
-
-  defaultShaderProgram.setBool("enableLight", currentContext->enableLighting);
-
-  defaultShaderProgram.setVec4("lightColor", currentContext->lightColor);
-  defaultShaderProgram.setVec3("lightPos", currentContext->lightPos);
-  defaultShaderProgram.setVec3("camPos", currentContext->cameraPosition);
-  defaultShaderProgram.setFloat("matAmbient", meshCommand.matData.ambient);
-  defaultShaderProgram.setFloat("matDiffuse", meshCommand.matData.diffuse);
-  defaultShaderProgram.setFloat("matSpecular", meshCommand.matData.specular);
-  defaultShaderProgram.setFloat("matShininess", meshCommand.matData.shininess);
 
   if (gpuTex) {
     gpuTex->Bind();
     gpuTex->texUnit(defaultShaderProgram, "tex0", 0);
   }
 
+  applyBlendMode(meshCommand.matData.resolvedBlendMode());
+
   gpuMesh->vao.Bind();
 
   glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(gpuMesh->indexCount),
@@ -375,8 +712,8 @@ void OpenGLRenderer::renderText(const UITextDrawCommand &cmd) {
       std::to_string(sdlColor.a);
 
   std::shared_ptr<Texture> textTex;
-  if (auto it = gpuTextureCache.find(cacheKey); it != gpuTextureCache.end()) {
-    textTex = it->second;
+  if (auto *cached = gpuTextureCache.find(cacheKey)) {
+    textTex = *cached;
   } else {
     SDL_Surface *srf =
         TTF_RenderUTF8_Blended(cmd.font->sdlFont, cmd.text.c_str(), sdlColor);
@@ -395,57 +732,55 @@ void OpenGLRenderer::renderText(const UITextDrawCommand &cmd) {
 
     const int w = rgba->w, h = rgba->h;
 
-    unsigned char *tight = (unsigned char *)malloc(w * h * 4);
-    if (!tight) {
-      SDL_FreeSurface(rgba);
-      std::cerr << "malloc failed\n";
-      return;
-    }
+    std::vector<unsigned char> tight(size_t(w) * h * 4);
     for (int y = 0; y < h; ++y) {
-      memcpy(tight + y * w * 4, (unsigned char *)rgba->pixels + y * rgba->pitch,
-             w * 4);
+      memcpy(tight.data() + size_t(y) * w * 4,
+             (unsigned char *)rgba->pixels + y * rgba->pitch, w * 4);
     }
     SDL_FreeSurface(rgba);
 
     ::farixEngine::Texture tempTex;
     tempTex.texWidth = w;
     tempTex.texHeight = h;
-    tempTex.texturePixels = tight;
+    tempTex.texturePixels = tight.data();
 
     textTex = std::make_shared<Texture>(&tempTex, GL_TEXTURE_2D, 1, GL_RGBA,
                                         GL_UNSIGNED_BYTE);
+    tempTex.texturePixels = nullptr;
 
-    // free(tight);
-
-    gpuTextureCache.emplace(cacheKey, textTex);
+    gpuTextureCache.insert(cacheKey, textTex, textureBytes(w, h));
   }
 
   std::shared_ptr<GPUMesh> quadMesh;
   const std::string meshKey = "textQuad_" + cacheKey;
-  if (auto it = gpuMeshCache.find(meshKey); it != gpuMeshCache.end()) {
-    quadMesh = it->second;
+  if (auto *cached = gpuMeshCache.find(meshKey)) {
+    quadMesh = *cached;
   } else {
     const float w = (float)textTex->width / 2;
     const float h = (float)textTex->height / 2;
 
-    MeshData mesh;
-    mesh.vertices.resize(4);
-    mesh.indices = {0, 1, 2, 2, 3, 0};
+    auto buffer = std::make_shared<MeshBuffer>();
+    std::vector<VertexData> &vertices = buffer->vertices;
+    vertices.resize(4);
+    buffer->indices = {0, 1, 2, 2, 3, 0};
 
     for (int i = 0; i < 4; ++i)
-      mesh.vertices[i].normal = {0.0f, 0.0f, 1.0f};
+      vertices[i].normal = {0.0f, 0.0f, 1.0f};
 
-    mesh.vertices[0].position = {cmd.pos.x - w, cmd.pos.y - h, 0.0f};
-    mesh.vertices[0].uv = {0.0f, 0.0f};
-    mesh.vertices[1].position = {cmd.pos.x + w, cmd.pos.y - h, 0.0f};
-    mesh.vertices[1].uv = {1.0f, 0.0f};
-    mesh.vertices[2].position = {cmd.pos.x + w, cmd.pos.y + h, 0.0f};
-    mesh.vertices[2].uv = {1.0f, 1.0f};
-    mesh.vertices[3].position = {cmd.pos.x - w, cmd.pos.y + h, 0.0f};
-    mesh.vertices[3].uv = {0.0f, 1.0f};
+    vertices[0].position = {cmd.pos.x - w, cmd.pos.y - h, 0.0f};
+    vertices[0].uv = {0.0f, 0.0f};
+    vertices[1].position = {cmd.pos.x + w, cmd.pos.y - h, 0.0f};
+    vertices[1].uv = {1.0f, 0.0f};
+    vertices[2].position = {cmd.pos.x + w, cmd.pos.y + h, 0.0f};
+    vertices[2].uv = {1.0f, 1.0f};
+    vertices[3].position = {cmd.pos.x - w, cmd.pos.y + h, 0.0f};
+    vertices[3].uv = {0.0f, 1.0f};
+
+    MeshData mesh;
+    mesh.buffer = std::move(buffer);
 
     quadMesh = std::make_shared<GPUMesh>(mesh);
-    gpuMeshCache.emplace(meshKey, quadMesh);
+    gpuMeshCache.insert(meshKey, quadMesh, meshBytes(mesh));
   }
 
   textShaderProgram.Activate();
@@ -455,6 +790,8 @@ void OpenGLRenderer::renderText(const UITextDrawCommand &cmd) {
   textTex->Bind();
   textShaderProgram.setInt("textTexture", 1);
 
+  applyBlendMode(BlendMode::Alpha);
+
   quadMesh->vao.Bind();
   glDrawElements(GL_TRIANGLES, (GLsizei)quadMesh->indexCount, GL_UNSIGNED_INT,
                  0);
@@ -468,12 +805,13 @@ std::array<int, 2> OpenGLRenderer::getScreenSize() {
 
 std::shared_ptr<GPUMesh>
 OpenGLRenderer::createOrGetGPUMesh(const std::shared_ptr<MeshData> &mesh) {
-  auto it = gpuMeshCache.find(mesh->uuid);
-  if (it != gpuMeshCache.end())
-    return it->second;
+  if (auto *cached = gpuMeshCache.find(mesh->uuid);
+      cached && (*cached)->version == mesh->version)
+    return *cached;
 
   auto gpuMesh = std::make_shared<GPUMesh>(*mesh);
-  gpuMeshCache[mesh->uuid] = gpuMesh;
+  gpuMesh->version = mesh->version;
+  gpuMeshCache.insert(mesh->uuid, gpuMesh, meshBytes(*mesh));
   return gpuMesh;
 }
 
@@ -481,13 +819,15 @@ std::shared_ptr<Texture>
 OpenGLRenderer::createOrGetGPUTexture(::farixEngine::Texture *tex) {
   if (!tex)
     return nullptr;
-  auto it = gpuTextureCache.find(tex->id);
-  if (it != gpuTextureCache.end())
-    return it->second;
+  if (auto *cached = gpuTextureCache.find(tex->id);
+      cached && (*cached)->version == tex->version)
+    return *cached;
 
   auto gpuTex = std::make_shared<Texture>(tex, GL_TEXTURE_2D, 0, GL_RGBA,
                                           GL_UNSIGNED_BYTE);
-  gpuTextureCache[tex->id] = gpuTex;
+  gpuTex->version = tex->version;
+  gpuTextureCache.insert(tex->id, gpuTex,
+                         textureBytes(tex->texWidth, tex->texHeight));
   return gpuTex;
 }
 
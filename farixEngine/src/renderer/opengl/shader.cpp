@@ -1,5 +1,6 @@
 #include "farixEngine/renderer/opengl/shader.hpp"
 
+#include <algorithm>
 #include <glm/gtc/type_ptr.hpp>
 namespace farixEngine::renderer {
 
@@ -38,6 +39,38 @@ Shader::Shader(const std::string &vertexFile, const std::string &fragmentFile) {
 
   glDeleteShader(vertexShader);
   glDeleteShader(fragShader);
+
+  cacheUniformLocations();
+}
+
+void Shader::cacheUniformLocations() {
+  GLint count = 0;
+  GLint maxLength = 0;
+  glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &count);
+  glGetProgramiv(ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+
+  std::string name(std::max(maxLength, 1), '\0');
+  for (GLint i = 0; i < count; ++i) {
+    GLsizei length = 0;
+    GLint size = 0;
+    GLenum type = 0;
+    glGetActiveUniform(ID, static_cast<GLuint>(i), maxLength, &length, &size,
+                       &type, name.data());
+    std::string uniform = name.substr(0, length);
+    // Members of uniform blocks have no location.
+    GLint location = glGetUniformLocation(ID, uniform.c_str());
+    if (location < 0)
+      continue;
+    uniformLocations[uniform] = location;
+    // Arrays are reported as "name[0]"; accept the bare name too.
+    if (uniform.size() > 3 && uniform.compare(uniform.size() - 3, 3, "[0]") == 0)
+      uniformLocations[uniform.substr(0, uniform.size() - 3)] = location;
+  }
+}
+
+GLint Shader::uniformLocation(const std::string &name) const {
+  auto it = uniformLocations.find(name);
+  return it != uniformLocations.end() ? it->second : -1;
 }
 
 void Shader::Activate() { glUseProgram(ID); }
@@ -45,33 +78,33 @@ void Shader::Activate() { glUseProgram(ID); }
 void Shader::Delete() { glDeleteProgram(ID); }
 
 void Shader::setBool(const std::string &name, bool value) const {
-  glUniform1i(glGetUniformLocation(ID, name.c_str()), static_cast<int>(value));
+  glUniform1i(uniformLocation(name), static_cast<int>(value));
 }
 
 void Shader::setInt(const std::string &name, int value) const {
-  glUniform1i(glGetUniformLocation(ID, name.c_str()), value);
+  glUniform1i(uniformLocation(name), value);
 }
  
 void Shader::setFloat(const std::string &name, float value) const {
-  glUniform1f(glGetUniformLocation(ID, name.c_str()), value); 
+  glUniform1f(uniformLocation(name), value); 
 }
 
 void Shader::setVec2(const std::string &name, const Vec2 &value) const {
-  glUniform2f(glGetUniformLocation(ID, name.c_str()), value.x, value.y);
+  glUniform2f(uniformLocation(name), value.x, value.y);
 }
 
 void Shader::setVec3(const std::string &name, const Vec3 &value) const {
-  glUniform3f(glGetUniformLocation(ID, name.c_str()), value.x, value.y,
+  glUniform3f(uniformLocation(name), value.x, value.y,
               value.z);
 }
 
 void Shader::setVec4(const std::string &name, const Vec4 &value) const {
-  glUniform4f(glGetUniformLocation(ID, name.c_str()), value.x, value.y, value.z,
+  glUniform4f(uniformLocation(name), value.x, value.y, value.z,
               value.w);
 }
 
 void Shader::setMat4(const std::string &name, const Mat4 &mat) const {
-  glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE,
+  glUniformMatrix4fv(uniformLocation(name), 1, GL_FALSE,
                      &mat[0][0]);
 }
 
@@ -29,8 +29,25 @@ Texture::Texture(::farixEngine::Texture *texture, GLenum texType, GLuint slot,
   glBindTexture(texType, 0);
 }
 
+void Texture::update(::farixEngine::Texture *texture, GLenum format,
+                     GLenum pixelType) {
+  glBindTexture(type, ID);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+  if (texture->texWidth == width && texture->texHeight == height) {
+    glTexSubImage2D(type, 0, 0, 0, texture->texWidth, texture->texHeight,
+                    format, pixelType, texture->texturePixels);
+  } else {
+    glTexImage2D(type, 0, GL_RGBA, texture->texWidth, texture->texHeight, 0,
+                 format, pixelType, texture->texturePixels);
+    width = texture->texWidth;
+    height = texture->texHeight;
+  }
+  glGenerateMipmap(type);
+  glBindTexture(type, 0);
+}
+
 void Texture::texUnit(Shader &shader, const char *uniform, GLuint unit) {
-  GLuint tex0Uni = glGetUniformLocation(shader.ID, uniform);
+  GLint tex0Uni = shader.uniformLocation(uniform);
   shader.Activate();
   glUniform1i(tex0Uni, unit);
 }
@@ -31,12 +31,14 @@ std::shared_ptr<MeshData> IRenderer::quadMesh2D() {
 
     float w = 0.5f, h = 0.5f;
 
-    quad->vertices = {{Vec3(-w, -h, 0), Vec3(0, 0, 1), Vec2(0, 0)},
-                      {Vec3(w, -h, 0), Vec3(0, 0, 1), Vec2(1, 0)},
-                      {Vec3(w, h, 0), Vec3(0, 0, 1), Vec2(1, 1)},
-                      {Vec3(-w, h, 0), Vec3(0, 0, 1), Vec2(0, 1)}};
-
-    quad->indices = {0, 1, 2, 0, 2, 3};
+    auto buffer = std::make_shared<MeshBuffer>();
+    buffer->vertices = {{Vec3(-w, -h, 0), Vec3(0, 0, 1), Vec2(0, 0)},
+                        {Vec3(w, -h, 0), Vec3(0, 0, 1), Vec2(1, 0)},
+                        {Vec3(w, h, 0), Vec3(0, 0, 1), Vec2(1, 1)},
+                        {Vec3(-w, h, 0), Vec3(0, 0, 1), Vec2(0, 1)}};
+
+    buffer->indices = {0, 1, 2, 0, 2, 3};
+    quad->buffer = std::move(buffer);
   }
 
   return quad;
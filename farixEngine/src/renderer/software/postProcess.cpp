@@ -0,0 +1,286 @@
+#include "farixEngine/renderer/software/postProcess.hpp"
+#include "farixEngine/math/simd.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace farixEngine::renderer {
+
+namespace {
+
+// Pixels whose local luma range is below max(kEdgeThresholdMin,
+// maxLuma >> kEdgeThresholdShift) are left untouched.
+constexpr int kEdgeThresholdMin = 16;
+constexpr int kEdgeThresholdShift = 3;
+constexpr int kEdgeSearchSteps = 12;
+constexpr float kSubpixelQuality = 0.75f;
+
+inline int lowestSetBit(uint32_t bits) {
+  int index = 0;
+  while (!(bits & 1u)) {
+    bits >>= 1;
+    ++index;
+  }
+  return index;
+}
+
+inline uint8_t lumaOf(uint32_t c) {
+  uint32_t r = (c >> 16) & 0xFF, g = (c >> 8) & 0xFF, b = c & 0xFF;
+  return static_cast<uint8_t>((r * 77 + g * 150 + b * 29) >> 8);
+}
+
+// Narkowicz's fit of the ACES filmic curve.
+inline float toneMapAces(float x) {
+  return (x * (2.51f * x + 0.03f)) / (x * (2.43f * x + 0.59f) + 0.14f);
+}
+
+inline float encodeSrgb(float v) {
+  return v <= 0.0031308f ? v * 12.92f
+                         : 1.055f * std::pow(v, 1.0f / 2.4f) - 0.055f;
+}
+
+} // namespace
+
+void PostProcessor::apply(const PostProcessSettings &settings,
+                          uint32_t *pixels, int width, int height,
+                          utils::ThreadPool &pool) {
+  if (!settings.enabled() || width <= 0 || height <= 0)
+    return;
+
+  this->width = width;
+  this->height = height;
+  const bool remap = settings.remapsColor();
+  if (remap)
+    buildColorLut(settings);
+  if (settings.fxaa) {
+    lumaStride = width + 2;
+    luma.resize(size_t(lumaStride) * (height + 2));
+    source.resize(size_t(width) * height);
+  }
+
+  const int tileRows = (height + kTileRows - 1) / kTileRows;
+  pool.parallelFor(tileRows, [&](int tile) {
+    prepareRows(pixels, tile * kTileRows,
+                std::min((tile + 1) * kTileRows, height), remap,
+                settings.fxaa);
+  });
+  if (!settings.fxaa)
+    return;
+
+  std::memcpy(luma.data(), luma.data() + lumaStride, lumaStride);
+  std::memcpy(luma.data() + size_t(height + 1) * lumaStride,
+              luma.data() + size_t(height) * lumaStride, lumaStride);
+
+  pool.parallelFor(tileRows, [&](int tile) {
+    fxaaRows(pixels, tile * kTileRows,
+             std::min((tile + 1) * kTileRows, height));
+  });
+}
+
+void PostProcessor::buildColorLut(const PostProcessSettings &settings) {
+  if (lutValid && lutSettings.toneMapping == settings.toneMapping &&
+      lutSettings.srgbEncode == settings.srgbEncode &&
+      lutSettings.exposure == settings.exposure)
+    return;
+
+  for (int i = 0; i < 256; ++i) {
+    float v = i / 255.0f * settings.exposure;
+    if (settings.toneMapping)
+      v = toneMapAces(v);
+    v = std::clamp(v, 0.0f, 1.0f);
+    if (settings.srgbEncode)
+      v = encodeSrgb(v);
+    colorLut[i] = static_cast<uint8_t>(std::lround(v * 255.0f));
+  }
+  lutSettings = settings;
+  lutValid = true;
+}
+
+void PostProcessor::prepareRows(uint32_t *pixels, int y0, int y1, bool remap,
+                                bool computeLuma) {
+  for (int y = y0; y < y1; ++y) {
+    uint32_t *row = pixels + size_t(y) * width;
+    if (remap) {
+      for (int x = 0; x < width; ++x) {
+        uint32_t c = row[x];
+        row[x] = (c & 0xFF000000) |
+                 (uint32_t(colorLut[(c >> 16) & 0xFF]) << 16) |
+                 (uint32_t(colorLut[(c >> 8) & 0xFF]) << 8) |
+                 colorLut[c & 0xFF];
+      }
+    }
+    if (!computeLuma)
+      continue;
+
+    std::memcpy(source.data() + size_t(y) * width, row,
+                size_t(width) * sizeof(uint32_t));
+    uint8_t *lumaRow = luma.data() + size_t(y + 1) * lumaStride;
+    for (int x = 0; x < width; ++x)
+      lumaRow[x + 1] = lumaOf(row[x]);
+    lumaRow[0] = lumaRow[1];
+    lumaRow[width + 1] = lumaRow[width];
+  }
+}
+
+int PostProcessor::lumaAt(int x, int y) const {
+  x = std::clamp(x, -1, width);
+  y = std::clamp(y, -1, height);
+  return luma[size_t(y + 1) * lumaStride + (x + 1)];
+}
+
+void PostProcessor::fxaaRows(uint32_t *pixels, int y0, int y1) const {
+  for (int y = y0; y < y1; ++y) {
+    const uint8_t *up = luma.data() + size_t(y) * lumaStride + 1;
+    const uint8_t *mid = up + lumaStride;
+    const uint8_t *down = mid + lumaStride;
+    int x = 0;
+
+    // Local contrast test on whole vectors of pixels; only the few that sit
+    // on an edge take the scalar path.
+#if defined(FARIX_SIMD_AVX2)
+    const __m256i thresholdMin = _mm256_set1_epi8(kEdgeThresholdMin);
+    const __m256i lowBits = _mm256_set1_epi8(0xFF >> kEdgeThresholdShift);
+    for (; x + 32 <= width; x += 32) {
+      auto load = [](const uint8_t *p) {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+      };
+      __m256i m = load(mid + x), n = load(up + x), s = load(down + x);
+      __m256i w = load(mid + x - 1), e = load(mid + x + 1);
+      __m256i hi = _mm256_max_epu8(
+          _mm256_max_epu8(_mm256_max_epu8(m, n), _mm256_max_epu8(s, w)), e);
+      __m256i lo = _mm256_min_epu8(
+          _mm256_min_epu8(_mm256_min_epu8(m, n), _mm256_min_epu8(s, w)), e);
+      __m256i range = _mm256_subs_epu8(hi, lo);
+      __m256i threshold = _mm256_max_epu8(
+          thresholdMin,
+          _mm256_and_si256(_mm256_srli_epi16(hi, kEdgeThresholdShift),
+                           lowBits));
+      __m256i below = _mm256_subs_epu8(threshold, range);
+      uint32_t edges = static_cast<uint32_t>(_mm256_movemask_epi8(
+          _mm256_cmpeq_epi8(below, _mm256_setzero_si256())));
+      while (edges) {
+        fxaaPixel(pixels, x + lowestSetBit(edges), y);
+        edges &= edges - 1;
+      }
+    }
+#elif defined(FARIX_SIMD_SSE2)
+    const __m128i thresholdMin = _mm_set1_epi8(kEdgeThresholdMin);
+    const __m128i lowBits = _mm_set1_epi8(0xFF >> kEdgeThresholdShift);
+    for (; x + 16 <= width; x += 16) {
+      auto load = [](const uint8_t *p) {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+      };
+      __m128i m = load(mid + x), n = load(up + x), s = load(down + x);
+      __m128i w = load(mid + x - 1), e = load(mid + x + 1);
+      __m128i hi =
+          _mm_max_epu8(_mm_max_epu8(_mm_max_epu8(m, n), _mm_max_epu8(s, w)), e);
+      __m128i lo =
+          _mm_min_epu8(_mm_min_epu8(_mm_min_epu8(m, n), _mm_min_epu8(s, w)), e);
+      __m128i range = _mm_subs_epu8(hi, lo);
+      __m128i threshold = _mm_max_epu8(
+          thresholdMin,
+          _mm_and_si128(_mm_srli_epi16(hi, kEdgeThresholdShift), lowBits));
+      __m128i below = _mm_subs_epu8(threshold, range);
+      uint32_t edges = static_cast<uint32_t>(
+          _mm_movemask_epi8(_mm_cmpeq_epi8(below, _mm_setzero_si128())));
+      while (edges) {
+        fxaaPixel(pixels, x + lowestSetBit(edges), y);
+        edges &= edges - 1;
+      }
+    }
+#endif
+    for (; x < width; ++x) {
+      int m = mid[x], n = up[x], s = down[x], w = mid[x - 1], e = mid[x + 1];
+      int hi = std::max({m, n, s, w, e});
+      int lo = std::min({m, n, s, w, e});
+      if (hi - lo >= std::max(kEdgeThresholdMin, hi >> kEdgeThresholdShift))
+        fxaaPixel(pixels, x, y);
+    }
+  }
+}
+
+// FXAA 3.11 quality path on integer pixel positions: estimate the edge
+// orientation, walk along it to find both ends, and blend towards the
+// neighbor across the edge by the distance to the nearer end.
+void PostProcessor::fxaaPixel(uint32_t *pixels, int x, int y) const {
+  float m = lumaAt(x, y);
+  float n = lumaAt(x, y - 1), s = lumaAt(x, y + 1);
+  float w = lumaAt(x - 1, y), e = lumaAt(x + 1, y);
+  float nw = lumaAt(x - 1, y - 1), ne = lumaAt(x + 1, y - 1);
+  float sw = lumaAt(x - 1, y + 1), se = lumaAt(x + 1, y + 1);
+
+  float range = std::max({m, n, s, w, e}) - std::min({m, n, s, w, e});
+  if (range <= 0.0f)
+    return;
+
+  float edgeHorz = std::abs(nw + sw - 2.0f * w) +
+                   2.0f * std::abs(n + s - 2.0f * m) +
+                   std::abs(ne + se - 2.0f * e);
+  float edgeVert = std::abs(nw + ne - 2.0f * n) +
+                   2.0f * std::abs(w + e - 2.0f * m) +
+                   std::abs(sw + se - 2.0f * s);
+  bool horzSpan = edgeHorz >= edgeVert;
+
+  float lumaA = horzSpan ? n : w;
+  float lumaB = horzSpan ? s : e;
+  float gradientA = lumaA - m, gradientB = lumaB - m;
+  bool pairA = std::abs(gradientA) >= std::abs(gradientB);
+  float gradient = std::max(std::abs(gradientA), std::abs(gradientB));
+  float pairAverage = 0.5f * (m + (pairA ? lumaA : lumaB));
+
+  // Across-edge offset to the paired neighbor and along-edge step.
+  int acrossX = horzSpan ? 0 : (pairA ? -1 : 1);
+  int acrossY = horzSpan ? (pairA ? -1 : 1) : 0;
+  int alongX = horzSpan ? 1 : 0;
+  int alongY = horzSpan ? 0 : 1;
+
+  auto edgeLuma = [&](int step) {
+    int px = x + alongX * step, py = y + alongY * step;
+    return 0.5f * (lumaAt(px, py) + lumaAt(px + acrossX, py + acrossY)) -
+           pairAverage;
+  };
+
+  float threshold = 0.25f * gradient;
+  float endN = 0.0f, endP = 0.0f;
+  int distN = kEdgeSearchSteps, distP = kEdgeSearchSteps;
+  for (int i = 1; i <= kEdgeSearchSteps; ++i) {
+    endN = edgeLuma(-i);
+    if (std::abs(endN) >= threshold) {
+      distN = i;
+      break;
+    }
+  }
+  for (int i = 1; i <= kEdgeSearchSteps; ++i) {
+    endP = edgeLuma(i);
+    if (std::abs(endP) >= threshold) {
+      distP = i;
+      break;
+    }
+  }
+
+  bool centerBelow = m - pairAverage < 0.0f;
+  bool nearerN = distN < distP;
+  float end = nearerN ? endN : endP;
+  float dist = float(std::min(distN, distP));
+  float edgeOffset = (end < 0.0f) != centerBelow
+                         ? 0.5f - dist / float(distN + distP)
+                         : 0.0f;
+
+  float lowpass = (2.0f * (n + s + w + e) + nw + ne + sw + se) / 12.0f;
+  float subpix = std::clamp(std::abs(lowpass - m) / range, 0.0f, 1.0f);
+  subpix = (-2.0f * subpix + 3.0f) * subpix * subpix;
+  subpix = subpix * subpix * kSubpixelQuality;
+
+  float offset = std::max(edgeOffset, subpix);
+  uint32_t weight = static_cast<uint32_t>(offset * 256.0f + 0.5f);
+  if (!weight)
+    return;
+
+  int nx = std::clamp(x + acrossX, 0, width - 1);
+  int ny = std::clamp(y + acrossY, 0, height - 1);
+  pixels[size_t(y) * width + x] =
+      lerpColor(source[size_t(y) * width + x],
+                source[size_t(ny) * width + nx], weight);
+}
+
+} // namespace farixEngine::renderer
@@ -1,27 +1,226 @@
-// NOT USED ANYMORE || OUTDATED || EXPERIMENTAL SOFTWARE RENDERER
 #include "farixEngine/renderer/software/softwareRenderer.hpp"
 #include "farixEngine/assets/mesh.hpp"
 #include "farixEngine/components/components.hpp"
 #include "farixEngine/core/world.hpp"
 #include "farixEngine/math/general.hpp"
 #include "farixEngine/math/mat4.hpp"
+#include "farixEngine/math/simd.hpp"
 #include "farixEngine/math/vec4.hpp"
 #include "farixEngine/renderer/renderData.hpp"
 #include "farixEngine/renderer/renderer.hpp"
+#include "farixEngine/renderer/software/postProcess.hpp"
 #include "farixEngine/utils/uuid.hpp"
 #include <SDL2/SDL.h>
 #include <SDL_ttf.h>
 #include <algorithm>
 #include <array>
+#include <chrono>
 #include <cmath>
+#include <cstring>
 #include <iostream>
 #include <utility>
 #include <vector>
 
 namespace farixEngine::renderer {
 
+namespace {
+
+enum Varying {
+  kDepth,
+  kInvW,
+  kU,
+  kV,
+  kNormalX,
+  kNormalY,
+  kNormalZ,
+  kPosX,
+  kPosY,
+  kPosZ,
+  kVaryingCount
+};
+
+// value(x, y) = origin + dx * x + dy * y, with (x, y) in whole pixels
+// relative to the plane's anchor pixel.
+struct AttributePlane {
+  float origin = 0;
+  float dx = 0;
+  float dy = 0;
+
+  float at(float x, float y) const { return origin + dx * x + dy * y; }
+};
+
+enum ClipPlane : uint32_t {
+  kClipLeft = 1,
+  kClipRight = 2,
+  kClipBottom = 4,
+  kClipTop = 8,
+  kClipNear = 16,
+  kClipFar = 32
+};
+
+// Clip-space outcode with the x/y planes widened by the given factors.
+inline uint32_t outcode(const Vec4 &v, float guardX, float guardY) {
+  uint32_t code = 0;
+  if (v.x < -guardX * v.w)
+    code |= kClipLeft;
+  if (v.x > guardX * v.w)
+    code |= kClipRight;
+  if (v.y < -guardY * v.w)
+    code |= kClipBottom;
+  if (v.y > guardY * v.w)
+    code |= kClipTop;
+  if (v.z < -v.w)
+    code |= kClipNear;
+  if (v.z > v.w)
+    code |= kClipFar;
+  return code;
+}
+
+// Signed distance to a clip plane; non-negative is inside.
+inline float planeDistance(const Vec4 &v, uint32_t plane, float guardX,
+                           float guardY) {
+  switch (plane) {
+  case kClipLeft:
+    return v.x + guardX * v.w;
+  case kClipRight:
+    return guardX * v.w - v.x;
+  case kClipBottom:
+    return v.y + guardY * v.w;
+  case kClipTop:
+    return guardY * v.w - v.y;
+  case kClipNear:
+    return v.z + v.w;
+  default:
+    return v.w - v.z;
+  }
+}
+
+// Approximate log2 for positive x: exponent plus linear mantissa, within 0.09.
+inline float fastLog2(float x) {
+  uint32_t bits;
+  std::memcpy(&bits, &x, sizeof(bits));
+  float exponent = static_cast<float>(static_cast<int>(bits >> 23) - 127);
+  bits = (bits & 0x007FFFFF) | 0x3F800000;
+  float mantissa;
+  std::memcpy(&mantissa, &bits, sizeof(mantissa));
+  return exponent + mantissa - 1.0f;
+}
+
+// Exact x / 255 for x in [0, 255 * 255], per 16-bit lane.
+#if defined(FARIX_SIMD_SSE2)
+inline __m128i div255(__m128i x) {
+  x = _mm_add_epi16(x, _mm_set1_epi16(128));
+  return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+}
+#else
+inline uint32_t div255(uint32_t x) {
+  x += 128;
+  return (x + (x >> 8)) >> 8;
+}
+#endif
+
+// Source-over in 8-bit integer math; the alpha channel accumulates coverage.
+inline uint32_t blendAlpha(uint32_t src, uint32_t dst) {
+  uint32_t a = src >> 24;
+#if defined(FARIX_SIMD_SSE2)
+  const __m128i zero = _mm_setzero_si128();
+  __m128i s = _mm_unpacklo_epi8(_mm_cvtsi32_si128(src | 0xFF000000), zero);
+  __m128i d = _mm_unpacklo_epi8(_mm_cvtsi32_si128(dst), zero);
+  __m128i out = _mm_add_epi16(_mm_mullo_epi16(s, _mm_set1_epi16(a)),
+                              _mm_mullo_epi16(d, _mm_set1_epi16(255 - a)));
+  return static_cast<uint32_t>(
+      _mm_cvtsi128_si32(_mm_packus_epi16(div255(out), zero)));
+#else
+  src |= 0xFF000000;
+  uint32_t out = 0;
+  for (int shift = 0; shift < 32; shift += 8) {
+    uint32_t s = (src >> shift) & 0xFF, d = (dst >> shift) & 0xFF;
+    out |= div255(s * a + d * (255 - a)) << shift;
+  }
+  return out;
+#endif
+}
+
+// Saturating dst + src * alpha.
+inline uint32_t blendAdditive(uint32_t src, uint32_t dst) {
+  uint32_t a = src >> 24;
+#if defined(FARIX_SIMD_SSE2)
+  const __m128i zero = _mm_setzero_si128();
+  __m128i s = _mm_unpacklo_epi8(_mm_cvtsi32_si128(src | 0xFF000000), zero);
+  __m128i scaled = _mm_packus_epi16(
+      div255(_mm_mullo_epi16(s, _mm_set1_epi16(a))), zero);
+  return static_cast<uint32_t>(
+      _mm_cvtsi128_si32(_mm_adds_epu8(scaled, _mm_cvtsi32_si128(dst))));
+#else
+  src |= 0xFF000000;
+  uint32_t out = 0;
+  for (int shift = 0; shift < 32; shift += 8) {
+    uint32_t s = div255(((src >> shift) & 0xFF) * a);
+    out |= std::min(255u, s + ((dst >> shift) & 0xFF)) << shift;
+  }
+  return out;
+#endif
+}
+
+// Bit i is set when all three edge functions are non-negative at column i of
+// an 8-pixel block row. `rowE` holds the edge values at the leftmost pixel and
+// `laneOffsets` the per-column increments.
+inline uint32_t rowCoverage(const int32_t rowE[3],
+                            const int32_t *const laneOffsets[3]) {
+#if defined(FARIX_SIMD_AVX2)
+  const __m256i negOne = _mm256_set1_epi32(-1);
+  __m256i inside = negOne;
+  for (int i = 0; i < 3; ++i) {
+    __m256i e = _mm256_add_epi32(
+        _mm256_set1_epi32(rowE[i]),
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(laneOffsets[i])));
+    inside = _mm256_and_si256(inside, _mm256_cmpgt_epi32(e, negOne));
+  }
+  return static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(inside)));
+#elif defined(FARIX_SIMD_SSE2)
+  const __m128i negOne = _mm_set1_epi32(-1);
+  __m128i insideLo = negOne;
+  __m128i insideHi = negOne;
+  for (int i = 0; i < 3; ++i) {
+    __m128i e = _mm_set1_epi32(rowE[i]);
+    __m128i lo = _mm_add_epi32(
+        e, _mm_loadu_si128(reinterpret_cast<const __m128i *>(laneOffsets[i])));
+    __m128i hi = _mm_add_epi32(e, _mm_loadu_si128(reinterpret_cast<const __m128i *>(
+                                      laneOffsets[i] + 4)));
+    insideLo = _mm_and_si128(insideLo, _mm_cmpgt_epi32(lo, negOne));
+    insideHi = _mm_and_si128(insideHi, _mm_cmpgt_epi32(hi, negOne));
+  }
+  return static_cast<uint32_t>(
+      _mm_movemask_ps(_mm_castsi128_ps(insideLo)) |
+      (_mm_movemask_ps(_mm_castsi128_ps(insideHi)) << 4));
+#else
+  uint32_t mask = 0;
+  for (int lane = 0; lane < 8; ++lane) {
+    if (rowE[0] + laneOffsets[0][lane] >= 0 &&
+        rowE[1] + laneOffsets[1][lane] >= 0 &&
+        rowE[2] + laneOffsets[2][lane] >= 0)
+      mask |= 1u << lane;
+  }
+  return mask;
+#endif
+}
+
+} // namespace
+
+SoftwareRenderer::SoftwareRenderer(int width, int height)
+    : IRenderer(width, height, "") {
+  framebuffer = new uint32_t[screenWidth * screenHeight];
+  zBuffer.resize(screenWidth * screenHeight);
+
+  tileMinDepth.resize(((screenWidth + kRasterBlockSize - 1) / kRasterBlockSize) *
+                      ((screenHeight + kRasterBlockSize - 1) / kRasterBlockSize));
+  tileMaxDepth.resize(tileMinDepth.size());
+  tileDepthDirty.resize(tileMinDepth.size());
+  resizeRenderTarget(screenWidth, screenHeight);
+}
+
 SoftwareRenderer::SoftwareRenderer(int width, int height, const char *title)
-    : IRenderer(width, height, title) {
+    : SoftwareRenderer(width, height) {
 
   if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_EVENTS | SDL_INIT_TIMER) != 0) {
     std::cerr << "SDL_Init Error: " << SDL_GetError() << std::endl;
@@ -49,20 +248,22 @@ SoftwareRenderer::SoftwareRenderer(int width, int height, const char *title)
               << std::endl;
     exit(1);
   }
-
-  framebuffer = new uint32_t[screenWidth * screenHeight];
-  zBuffer.resize(screenWidth * screenHeight);
 }
 
 SoftwareRenderer::~SoftwareRenderer() {
+  setPipelined(false);
   delete[] framebuffer;
-  SDL_DestroyTexture(sdlTexture);
-  SDL_DestroyRenderer(sdlRenderer);
-  SDL_DestroyWindow(window);
+  if (sdlTexture)
+    SDL_DestroyTexture(sdlTexture);
+  if (sdlRenderer)
+    SDL_DestroyRenderer(sdlRenderer);
+  if (window)
+    SDL_DestroyWindow(window);
 }
 
 void SoftwareRenderer::beginFrame() {
-  clear();
+  if (!pipelined)
+    clear();
   passes.clear();
   activePass = nullptr;
   currentContext = nullptr;
@@ -97,8 +298,211 @@ void SoftwareRenderer::setContext(RenderContext &context) {
 }
 
 void SoftwareRenderer::endFrame() {
-  for (auto &pass : passes) {
-    setContext(pass.context);
+  if (!pipelined) {
+    renderPasses.swap(passes);
+    framePostProcess = postProcess;
+    renderFrame();
+    present();
+    return;
+  }
+
+  waitForFrame();
+  renderPasses.swap(passes);
+  framePostProcess = postProcess;
+  {
+    std::lock_guard<std::mutex> lock(frameMutex);
+    frameQueued = true;
+  }
+  frameQueuedCv.notify_one();
+}
+
+void SoftwareRenderer::waitForFrame() {
+  if (!pipelined)
+    return;
+
+  bool presentFrame = false;
+  {
+    std::unique_lock<std::mutex> lock(frameMutex);
+    frameDoneCv.wait(lock, [this] { return !frameQueued; });
+    std::swap(presentFrame, framePresentPending);
+  }
+  // The render thread is idle here, so present() may touch the framebuffer.
+  if (presentFrame)
+    present();
+}
+
+void SoftwareRenderer::setPipelined(bool enabled) {
+  if (enabled == pipelined)
+    return;
+
+  if (enabled) {
+    stopRenderThread = false;
+    renderThread = std::thread(&SoftwareRenderer::renderThreadLoop, this);
+    pipelined = true;
+    return;
+  }
+
+  waitForFrame();
+  {
+    std::lock_guard<std::mutex> lock(frameMutex);
+    stopRenderThread = true;
+  }
+  frameQueuedCv.notify_one();
+  renderThread.join();
+  pipelined = false;
+}
+
+void SoftwareRenderer::renderThreadLoop() {
+  std::unique_lock<std::mutex> lock(frameMutex);
+  while (true) {
+    frameQueuedCv.wait(lock, [this] { return frameQueued || stopRenderThread; });
+    if (!frameQueued)
+      return;
+
+    lock.unlock();
+    clear();
+    renderFrame();
+    lock.lock();
+
+    frameQueued = false;
+    framePresentPending = true;
+    frameDoneCv.notify_all();
+  }
+}
+
+void SoftwareRenderer::setRenderTimeBudget(float budgetMs, float minScale) {
+  renderBudgetMs = std::max(budgetMs, 0.0f);
+  minResolutionScale = std::clamp(minScale, 0.1f, 1.0f);
+}
+
+void SoftwareRenderer::resizeRenderTarget(int width, int height) {
+  targetWidth = std::clamp(width, 1, screenWidth);
+  targetHeight = std::clamp(height, 1, screenHeight);
+  if (targetWidth == screenWidth && targetHeight == screenHeight) {
+    colorTarget = framebuffer;
+  } else {
+    scaledColor.resize(size_t(screenWidth) * screenHeight);
+    colorTarget = scaledColor.data();
+  }
+  tilesX = (targetWidth + kRasterBlockSize - 1) / kRasterBlockSize;
+  tilesY = (targetHeight + kRasterBlockSize - 1) / kRasterBlockSize;
+}
+
+void SoftwareRenderer::setPostProcess(const PostProcessSettings &settings) {
+  postProcess = settings;
+}
+
+utils::ThreadPool &SoftwareRenderer::workerPool() {
+  if (!shadingPool)
+    shadingPool = std::make_unique<utils::ThreadPool>();
+  return *shadingPool;
+}
+
+void SoftwareRenderer::upsampleToFramebuffer() {
+  // Bilinear taps at output pixel centers, with 8-bit weights.
+  auto tap = [](int i, int srcSize, int dstSize, int &i0, int &i1,
+                uint32_t &weight) {
+    float src = (i + 0.5f) * srcSize / dstSize - 0.5f;
+    float base = std::floor(src);
+    i0 = std::clamp(int(base), 0, srcSize - 1);
+    i1 = std::min(i0 + 1, srcSize - 1);
+    weight = src > 0 ? uint32_t((src - base) * 256.0f) : 0;
+  };
+
+  std::vector<int> x0(screenWidth), x1(screenWidth);
+  std::vector<uint32_t> wx(screenWidth);
+  for (int x = 0; x < screenWidth; ++x)
+    tap(x, targetWidth, screenWidth, x0[x], x1[x], wx[x]);
+
+  workerPool().parallelFor(screenHeight, [&](int y) {
+    int y0, y1;
+    uint32_t wy;
+    tap(y, targetHeight, screenHeight, y0, y1, wy);
+    const uint32_t *top = colorTarget + size_t(y0) * targetWidth;
+    const uint32_t *bottom = colorTarget + size_t(y1) * targetWidth;
+    uint32_t *out = framebuffer + size_t(y) * screenWidth;
+    for (int x = 0; x < screenWidth; ++x) {
+      uint32_t upper = lerpColor(top[x0[x]], top[x1[x]], wx[x]);
+      uint32_t lower = lerpColor(bottom[x0[x]], bottom[x1[x]], wx[x]);
+      out[x] = lerpColor(upper, lower, wy);
+    }
+  });
+}
+
+void SoftwareRenderer::updateResolutionScale(float renderMs) {
+  float budget = renderBudgetMs;
+  float scale = resolutionScale;
+  if (budget <= 0.0f) {
+    smoothedRenderMs = 0.0f;
+    if (scale != 1.0f) {
+      resolutionScale = 1.0f;
+      resizeRenderTarget(screenWidth, screenHeight);
+    }
+    return;
+  }
+
+  smoothedRenderMs = smoothedRenderMs > 0.0f
+                        ? smoothedRenderMs + 0.1f * (renderMs - smoothedRenderMs)
+                        : renderMs;
+
+  // Raster cost follows the pixel count, so aim the scale at the square root
+  // of the remaining headroom. Steps are capped per frame and small
+  // corrections are ignored so the resolution does not oscillate.
+  constexpr float kTargetFraction = 0.9f;
+  constexpr float kMaxStep = 0.05f;
+  constexpr float kDeadZone = 0.02f;
+  float ideal =
+      scale * std::sqrt(kTargetFraction * budget / smoothedRenderMs);
+  float next = std::clamp(ideal, scale - kMaxStep, scale + kMaxStep);
+  next = std::clamp(next, float(minResolutionScale), 1.0f);
+  if (std::abs(next - scale) < kDeadZone && next != 1.0f)
+    return;
+
+  int width = std::max(1, int(std::lround(screenWidth * next)));
+  int height = std::max(1, int(std::lround(screenHeight * next)));
+  if (width == targetWidth && height == targetHeight)
+    return;
+
+  // Predict the cost at the new size until fresh samples arrive.
+  smoothedRenderMs *= float(width) * height / (float(targetWidth) * targetHeight);
+  resolutionScale = next;
+  resizeRenderTarget(width, height);
+}
+
+void SoftwareRenderer::renderFrame() {
+  auto start = std::chrono::steady_clock::now();
+  for (auto &pass : renderPasses) {
+    rasterContext = &pass.context;
+    lightDirView =
+        (pass.context.viewMatrix * Vec4(lightDir, 0)).toVec3().normalized();
+
+    if (pass.context.deferredShading) {
+      size_t opaqueCount = sortDrawOrder(pass);
+      const size_t pixelCount = size_t(targetWidth) * targetHeight;
+      gMaterial.assign(pixelCount, 0);
+      gNormal.resize(pixelCount);
+      gSurface.resize(pixelCount);
+      deferredMaterials.clear();
+
+      for (size_t i = 0; i < opaqueCount; ++i) {
+        const MeshCommand &command = pass.meshCommands[drawOrder[i]];
+        deferredMaterials.push_back(&command.matData);
+        activeMaterialId = static_cast<uint32_t>(deferredMaterials.size());
+        renderMesh(command);
+      }
+      activeMaterialId = 0;
+      resolveDeferred(pass.context);
+
+      for (size_t i = opaqueCount; i < drawOrder.size(); ++i)
+        renderMesh(pass.meshCommands[drawOrder[i]]);
+      continue;
+    }
+    if (pass.context.sortOpaqueFrontToBack) {
+      sortDrawOrder(pass);
+      for (uint32_t index : drawOrder)
+        renderMesh(pass.meshCommands[index]);
+      continue;
+    }
     for (auto &mesh : pass.meshCommands) {
       renderMesh(mesh);
     }
@@ -106,8 +510,16 @@ void SoftwareRenderer::endFrame() {
     //   renderText(text);
     // }
   }
-
-  present();
+  rasterContext = nullptr;
+
+  if (framePostProcess.enabled())
+    postProcessor.apply(framePostProcess, colorTarget, targetWidth,
+                        targetHeight, workerPool());
+  if (colorTarget != framebuffer)
+    upsampleToFramebuffer();
+  std::chrono::duration<float, std::milli> elapsed =
+      std::chrono::steady_clock::now() - start;
+  updateResolutionScale(elapsed.count());
 }
 
 void SoftwareRenderer::clear(uint32_t color) {
@@ -120,8 +532,104 @@ void SoftwareRenderer::clear(uint32_t color) {
     return;
   }
 
-  std::fill(framebuffer, framebuffer + screenWidth * screenHeight, color);
-  std::fill(zBuffer.begin(), zBuffer.end(), std::numeric_limits<float>::max());
+  const size_t pixelCount = size_t(targetWidth) * targetHeight;
+  const size_t tileCount = size_t(tilesX) * tilesY;
+  std::fill(colorTarget, colorTarget + pixelCount, color);
+  std::fill(zBuffer.begin(), zBuffer.begin() + pixelCount,
+            std::numeric_limits<float>::max());
+  std::fill(tileMinDepth.begin(), tileMinDepth.begin() + tileCount,
+            std::numeric_limits<float>::max());
+  std::fill(tileMaxDepth.begin(), tileMaxDepth.begin() + tileCount,
+            std::numeric_limits<float>::max());
+  std::fill(tileDepthDirty.begin(), tileDepthDirty.begin() + tileCount, 0);
+}
+
+size_t SoftwareRenderer::sortDrawOrder(const RenderPass &pass) {
+  const auto &commands = pass.meshCommands;
+  drawOrder.resize(commands.size());
+  for (uint32_t i = 0; i < commands.size(); ++i)
+    drawOrder[i] = i;
+
+  auto isOpaque = [&](uint32_t i) {
+    return commands[i].matData.resolvedBlendMode() == BlendMode::Opaque;
+  };
+  auto firstTranslucent =
+      std::stable_partition(drawOrder.begin(), drawOrder.end(), isOpaque);
+  size_t opaqueCount = firstTranslucent - drawOrder.begin();
+  if (!pass.context.sortOpaqueFrontToBack)
+    return opaqueCount;
+
+  // View-space z of each object's origin; larger is closer to the camera.
+  const Vec4 viewZRow = pass.context.viewMatrix.getRow(2);
+  sortDepths.resize(commands.size());
+  for (uint32_t i = 0; i < commands.size(); ++i)
+    sortDepths[i] = viewZRow.dot(commands[i].modelMatrix.getCol(3));
+
+  std::stable_sort(drawOrder.begin(), firstTranslucent,
+                   [&](uint32_t a, uint32_t b) {
+                     return sortDepths[a] > sortDepths[b];
+                   });
+  return opaqueCount;
+}
+
+void SoftwareRenderer::resolveDeferred(const RenderContext &ctx) {
+  // World positions are rebuilt from depth, so the G-buffer does not store
+  // them.
+  const Mat4 invViewProj =
+      (ctx.projectionMatrix * ctx.viewMatrix).inverse();
+  const float ndcScaleX = 2.0f / targetWidth;
+  const float ndcScaleY = 2.0f / targetHeight;
+
+  workerPool().parallelFor(tilesY, [&](int tileRow) {
+    int y0 = tileRow * kRasterBlockSize;
+    int y1 = std::min(y0 + kRasterBlockSize, targetHeight);
+    for (int y = y0; y < y1; ++y) {
+      float ndcY = 1.0f - (y + 0.5f) * ndcScaleY;
+      for (int x = 0; x < targetWidth; ++x) {
+        int index = y * targetWidth + x;
+        uint32_t materialId = gMaterial[index];
+        if (!materialId)
+          continue;
+
+        Vec3 worldPos;
+        if (ctx.enableLighting) {
+          float ndcX = (x + 0.5f) * ndcScaleX - 1.0f;
+          Vec4 p = invViewProj * Vec4(ndcX, ndcY, zBuffer[index], 1.0f);
+          worldPos = p.xyz() / p.w;
+        }
+        Vec4 color =
+            shadeFragment(worldPos, gSurface[index], gNormal[index], ctx,
+                          *deferredMaterials[materialId - 1]);
+        colorTarget[index] = packColor(color) | 0xFF000000;
+      }
+    }
+  });
+}
+
+void SoftwareRenderer::updateTileDepth(int tileX, int tileY) {
+  int x0 = tileX * kRasterBlockSize;
+  int y0 = tileY * kRasterBlockSize;
+  int x1 = std::min(x0 + kRasterBlockSize, targetWidth);
+  int y1 = std::min(y0 + kRasterBlockSize, targetHeight);
+
+  float minDepth = std::numeric_limits<float>::max();
+  float maxDepth = std::numeric_limits<float>::lowest();
+  for (int y = y0; y < y1; ++y) {
+    const float *row = zBuffer.data() + y * targetWidth;
+    for (int x = x0; x < x1; ++x) {
+      minDepth = std::min(minDepth, row[x]);
+      maxDepth = std::max(maxDepth, row[x]);
+    }
+  }
+  tileMinDepth[tileY * tilesX + tileX] = minDepth;
+  tileMaxDepth[tileY * tilesX + tileX] = maxDepth;
+  tileDepthDirty[tileY * tilesX + tileX] = 0;
+}
+
+void SoftwareRenderer::widenTileDepth(int tileIndex, float minZ, float maxZ) {
+  tileMinDepth[tileIndex] = std::min(tileMinDepth[tileIndex], minZ);
+  tileMaxDepth[tileIndex] = std::max(tileMaxDepth[tileIndex], maxZ);
+  tileDepthDirty[tileIndex] = 1;
 }
 
 void SoftwareRenderer::present() {
@@ -144,24 +652,28 @@ Vec4 SoftwareRenderer::project(const Vec4 &point, const Mat4 &model,
 }
 
 void SoftwareRenderer::drawPixel(int x, int y, float z, uint32_t color) {
-  if (x >= 0 && x < screenWidth && y >= 0 && y < screenHeight) {
-    int index = y * screenWidth + x;
-    if (currentContext->enableZBuffer && z >= zBuffer[index])
+  if (x >= 0 && x < targetWidth && y >= 0 && y < targetHeight) {
+    int index = y * targetWidth + x;
+    if (rasterContext->enableZBuffer && z >= zBuffer[index])
       return;
     zBuffer[index] = z;
+    blendPixel(index, color);
+    widenTileDepth((y / kRasterBlockSize) * tilesX + x / kRasterBlockSize, z,
+                   z);
+  }
+}
 
-    Vec4 src = unpackColor(color);
-    Vec4 dst = unpackColor(framebuffer[index]);
-    float alpha = src.w;
-
-    Vec3 outRGB = src.xyz() * alpha + dst.xyz() * (1.0f - alpha);
-    float outA = alpha + dst.w * (1.0f - alpha);
-
-    Vec4 outColor(std::clamp(outRGB.x, 0.f, 1.f),
-                  std::clamp(outRGB.y, 0.f, 1.f),
-                  std::clamp(outRGB.z, 0.f, 1.f), std::clamp(outA, 0.f, 1.f));
-
-    framebuffer[index] = packColor(outColor);
+void SoftwareRenderer::blendPixel(int index, uint32_t color, BlendMode mode) {
+  switch (mode) {
+  case BlendMode::Opaque:
+    colorTarget[index] = color | 0xFF000000;
+    break;
+  case BlendMode::Alpha:
+    colorTarget[index] = blendAlpha(color, colorTarget[index]);
+    break;
+  case BlendMode::Additive:
+    colorTarget[index] = blendAdditive(color, colorTarget[index]);
+    break;
   }
 }
 
@@ -190,9 +702,10 @@ std::array<Vec4, 3> SoftwareRenderer::fetchTransformedVertices(
     const MeshData &mesh, const TriangleData &tri, const Mat4 &model,
     const RenderContext &ctx) const {
 
-  Vec4 v0 = project(Vec4(mesh.vertices[tri.i0].position, 1), model, ctx);
-  Vec4 v1 = project(Vec4(mesh.vertices[tri.i1].position, 1), model, ctx);
-  Vec4 v2 = project(Vec4(mesh.vertices[tri.i2].position, 1), model, ctx);
+  const auto &vertices = mesh.vertices();
+  Vec4 v0 = project(Vec4(vertices[tri.i0].position, 1), model, ctx);
+  Vec4 v1 = project(Vec4(vertices[tri.i1].position, 1), model, ctx);
+  Vec4 v2 = project(Vec4(vertices[tri.i2].position, 1), model, ctx);
   return {v0, v1, v2};
 }
 Vec4 SoftwareRenderer::toCameraSpace(const Vec3 &pos, const Mat4 &model,
@@ -212,48 +725,18 @@ Vec4 SoftwareRenderer::ndcToScreen(Vec4 &posClip, int screenWidth,
   return Vec4(x, y, z, posClip.w);
 }
 
-bool SoftwareRenderer::isTriangleVisible(std::array<Vec4, 3> &projected,
-                                         const MaterialData &material,
-                                         const RenderContext &ctx) const {
-
-  if (!isTriangleValid(projected[0], projected[1], projected[2]))
-    return false;
-
+bool SoftwareRenderer::isTriangleVisible(const Vec4 &c0, const Vec4 &c1,
+                                         const Vec4 &c2,
+                                         const MaterialData &material) const {
   if (material.doubleSided)
     return true;
 
-  Vec3 normal = (projected[1].toVec3() - projected[0].toVec3())
-                    .cross(projected[2].toVec3() - projected[0].toVec3())
-                    .normalized();
-
-  Vec3 viewDir = (ctx.viewMatrix.getCol(2).xyz().normalized()) * -1;
-  return normal.dot(viewDir) < 0.2f;
-}
-
-std::array<Vec2, 3>
-SoftwareRenderer::fetchUVs(const MeshData &mesh, const TriangleData &tri,
-                           const MaterialData &material) const {
-
-  if (material.useTexture && !mesh.vertices.empty()) {
-    return {mesh.vertices[tri.i0].uv, mesh.vertices[tri.i1].uv,
-            mesh.vertices[tri.i2].uv};
-  }
-  return {Vec2(), Vec2(), Vec2()};
-}
-
-std::array<Vec3, 3>
-SoftwareRenderer::fetchNs(const MeshData &mesh, const TriangleData &tri,
-                          const MaterialData &material) const {
-
-  return {mesh.vertices[tri.i0].normal, mesh.vertices[tri.i1].normal,
-          mesh.vertices[tri.i2].normal};
-}
-std::array<Vec3, 3>
-SoftwareRenderer::fetchPs(const MeshData &mesh, const TriangleData &tri,
-                          const MaterialData &material) const {
-
-  return {mesh.vertices[tri.i0].position, mesh.vertices[tri.i1].position,
-          mesh.vertices[tri.i2].position};
+  // Sign of the homogeneous (x, y, w) determinant: positive for
+  // counter-clockwise triangles, valid even with vertices behind the eye.
+  float det = c0.x * (c1.y * c2.w - c2.y * c1.w) -
+              c0.y * (c1.x * c2.w - c2.x * c1.w) +
+              c0.w * (c1.x * c2.y - c2.x * c1.y);
+  return det > 0.0f;
 }
 
 void SoftwareRenderer::rasterizeTriangle(const std::array<Vec4, 3> &projected,
@@ -263,77 +746,293 @@ void SoftwareRenderer::rasterizeTriangle(const std::array<Vec4, 3> &projected,
                                          const RenderContext &ctx,
                                          const MaterialData &material) {
 
-  float minX = std::min({projected[0].x, projected[1].x, projected[2].x});
-  float maxX = std::max({projected[0].x, projected[1].x, projected[2].x});
-  float minY = std::min({projected[0].y, projected[1].y, projected[2].y});
-  float maxY = std::max({projected[0].y, projected[1].y, projected[2].y});
+  // Snap to 28.4 fixed point. The clamp keeps every edge product inside
+  // int64; geometry that far outside the screen is clipped before this.
+  constexpr int subPixel = 1 << kSubPixelBits;
+  constexpr float maxCoord = float(1 << 24);
+  int64_t fx[3], fy[3];
+  for (int i = 0; i < 3; ++i) {
+    fx[i] = std::llround(std::clamp(projected[i].x, -maxCoord, maxCoord) *
+                         subPixel);
+    fy[i] = std::llround(std::clamp(projected[i].y, -maxCoord, maxCoord) *
+                         subPixel);
+  }
 
-  int minXInt = std::max(0, (int)std::floor(minX));
-  int maxXInt = std::min(screenWidth - 1, (int)std::ceil(maxX));
-  int minYInt = std::max(0, (int)std::floor(minY));
-  int maxYInt = std::min(screenHeight - 1, (int)std::ceil(maxY));
+  int64_t area =
+      (fx[1] - fx[0]) * (fy[2] - fy[0]) - (fy[1] - fy[0]) * (fx[2] - fx[0]);
+  if (area == 0)
+    return;
 
-  float area = edgeFunction(projected[0], projected[1], projected[2]);
-  if (std::abs(area) < 1e-6f)
+  // Pixels are sampled at their centers; the bounds cover every center
+  // inside the snapped bounding box.
+  constexpr int64_t halfPixel = subPixel / 2;
+  int64_t minFx = std::min({fx[0], fx[1], fx[2]});
+  int64_t maxFx = std::max({fx[0], fx[1], fx[2]});
+  int64_t minFy = std::min({fy[0], fy[1], fy[2]});
+  int64_t maxFy = std::max({fy[0], fy[1], fy[2]});
+  int minXInt = (int)std::max<int64_t>(
+      0, (minFx - halfPixel + subPixel - 1) >> kSubPixelBits);
+  int maxXInt = (int)std::min<int64_t>(targetWidth - 1,
+                                       (maxFx - halfPixel) >> kSubPixelBits);
+  int minYInt = (int)std::max<int64_t>(
+      0, (minFy - halfPixel + subPixel - 1) >> kSubPixelBits);
+  int maxYInt = (int)std::min<int64_t>(targetHeight - 1,
+                                       (maxFy - halfPixel) >> kSubPixelBits);
+  if (minXInt > maxXInt || minYInt > maxYInt)
     return;
 
-  for (int y = minYInt; y <= maxYInt; ++y) {
-    for (int x = minXInt; x <= maxXInt; ++x) {
-      Vec3 p(x, y, 0);
-      float w0 = edgeFunction(projected[1], projected[2], p);
-      float w1 = edgeFunction(projected[2], projected[0], p);
-      float w2 = edgeFunction(projected[0], projected[1], p);
-
-      if ((w0 >= 0 && w1 >= 0 && w2 >= 0) || (w0 <= 0 && w1 <= 0 && w2 <= 0)) {
-        float alpha = w0 / area, beta = w1 / area, gamma = w2 / area;
-        float depth = alpha * projected[0].z + beta * projected[1].z +
-                      gamma * projected[2].z;
-        if (!std::isfinite(depth) || depth < 0 || depth > 1)
-          continue;
+  // Edge functions flipped so the interior is non-negative for both
+  // windings. Top-left rule: pixel centers exactly on an edge belong to the
+  // triangle only for left edges (a > 0) and top edges (a == 0, b > 0), so a
+  // shared edge is owned by exactly one of its two triangles.
+  int64_t sign = area < 0 ? -1 : 1;
+  area *= sign;
+  EdgeSetup edges;
+  int64_t stepX[3], stepY[3];
+  bool wide = false;
+  for (int i = 0; i < 3; ++i) {
+    int a = (i + 1) % 3, b = (i + 2) % 3;
+    edges.a[i] = (fy[a] - fy[b]) * sign;
+    edges.b[i] = (fx[b] - fx[a]) * sign;
+    edges.c[i] = -(edges.a[i] * fx[a] + edges.b[i] * fy[a]);
+    bool topLeft = edges.a[i] > 0 || (edges.a[i] == 0 && edges.b[i] > 0);
+    if (!topLeft)
+      edges.c[i] -= 1;
+
+    stepX[i] = edges.a[i] * subPixel;
+    stepY[i] = edges.b[i] * subPixel;
+    wide |= std::max(std::abs(stepX[i]), std::abs(stepY[i])) > (1 << 20);
+  }
 
-        Vec3 worldPos = ps[0] * alpha + ps[1] * beta + ps[2] * gamma;
-
-        float invW = alpha / projected[0].w + beta / projected[1].w +
-                     gamma / projected[2].w;
-        float u = (alpha * uvs[0].x / projected[0].w +
-                   beta * uvs[1].x / projected[1].w +
-                   gamma * uvs[2].x / projected[2].w) /
-                  invW;
-        float v = (alpha * uvs[0].y / projected[0].w +
-                   beta * uvs[1].y / projected[1].w +
-                   gamma * uvs[2].y / projected[2].w) /
-                  invW;
-        float remappedU =
-            material.uvMin[0] + u * (material.uvMax[0] - material.uvMin[0]);
-        float remappedV =
-            material.uvMin[1] + v * (material.uvMax[1] - material.uvMin[1]);
-        Vec3 interpolatedNormal = (ns[0] * (alpha / projected[0].w) +
-                                   ns[1] * (beta / projected[1].w) +
-                                   ns[2] * (gamma / projected[2].w)) /
-                                  invW;
-
-        interpolatedNormal = interpolatedNormal.normalized();
-
-        Vec4 finalColor = shadeFragment(worldPos, Vec3(remappedU, remappedV, 0),
-                                        interpolatedNormal, ctx, material);
-
-        drawPixel(x, y, depth, packColor(finalColor));
-      }
+  // Edge values at the center of pixel (0, 0).
+  int64_t originE[3];
+  for (int i = 0; i < 3; ++i)
+    originE[i] = edges.a[i] * halfPixel + edges.b[i] * halfPixel + edges.c[i];
+
+  // Per-column offsets of each edge within an 8-pixel block row. Edges that
+  // trivially accept a block use the zero row instead.
+  int32_t laneOffsets[3][kRasterBlockSize];
+  static const int32_t zeroOffsets[kRasterBlockSize] = {};
+  if (!wide) {
+    for (int i = 0; i < 3; ++i)
+      for (int lane = 0; lane < kRasterBlockSize; ++lane)
+        laneOffsets[i][lane] = int32_t(stepX[i] * lane);
+  }
+
+  // Attribute planes: depth is affine in screen space, everything else is
+  // interpolated as attr/w and divided by the interpolated 1/w per pixel.
+  float invW[3], values[kVaryingCount][3];
+  for (int i = 0; i < 3; ++i) {
+    invW[i] = 1.0f / projected[i].w;
+    values[kDepth][i] = projected[i].z;
+    values[kInvW][i] = invW[i];
+    values[kU][i] = uvs[i].x * invW[i];
+    values[kV][i] = uvs[i].y * invW[i];
+    values[kNormalX][i] = ns[i].x * invW[i];
+    values[kNormalY][i] = ns[i].y * invW[i];
+    values[kNormalZ][i] = ns[i].z * invW[i];
+    values[kPosX][i] = ps[i].x * invW[i];
+    values[kPosY][i] = ps[i].y * invW[i];
+    values[kPosZ][i] = ps[i].z * invW[i];
+  }
+  // Planes are anchored at the first block so per-pixel evaluation does
+  // not extrapolate from the screen origin.
+  constexpr int blockSpan = kRasterBlockSize - 1;
+  int blockMinX = minXInt & ~blockSpan;
+  int blockMinY = minYInt & ~blockSpan;
+  AttributePlane planes[kVaryingCount];
+  for (int k = 0; k < kVaryingCount; ++k) {
+    double dx = 0, dy = 0, origin = 0;
+    for (int i = 0; i < 3; ++i) {
+      int64_t anchorE = originE[i] + stepX[i] * blockMinX + stepY[i] * blockMinY;
+      dx += double(stepX[i]) * values[k][i];
+      dy += double(stepY[i]) * values[k][i];
+      origin += double(anchorE) * values[k][i];
     }
+    planes[k] = {float(origin / area), float(dx / area), float(dy / area)};
   }
-}
 
-bool SoftwareRenderer::isTriangleVisibleInFrustum(const Vec4 &v0,
-                                                  const Vec4 &v1,
-                                                  const Vec4 &v2) {
+  // Screen-space depth plane, used for per-block hierarchical depth tests.
+  float dzdx = planes[kDepth].dx, dzdy = planes[kDepth].dy;
+  float triMinZ = std::min({projected[0].z, projected[1].z, projected[2].z});
+  float triMaxZ = std::max({projected[0].z, projected[1].z, projected[2].z});
+
+  // Texel footprint scale for mip level selection.
+  bool sampleMips = material.useTexture && material.texture &&
+                    !material.texture->mips.empty();
+  float texelsU = 0, texelsV = 0;
+  if (sampleMips) {
+    texelsU =
+        material.texture->texWidth * (material.uvMax[0] - material.uvMin[0]);
+    texelsV =
+        material.texture->texHeight * (material.uvMax[1] - material.uvMin[1]);
+  }
 
-  auto inside = [](const Vec4 &v) {
-    return v.x >= -v.w && v.x <= v.w && v.y >= -v.w && v.y <= v.w &&
-           v.z >= -v.w && v.z <= v.w && v.w > 0;
+  const BlendMode blendMode = activeBlendMode;
+  const uint32_t materialId = activeMaterialId;
+
+  // Depth range and count of the pixels written in the current block.
+  float writtenMinZ = 0.0f, writtenMaxZ = 0.0f;
+  int writtenCount = 0;
+
+  auto shadePixel = [&](int x, int y, const float *v, bool depthTest) {
+    float depth = v[kDepth];
+    if (!std::isfinite(depth) || depth < 0 || depth > 1)
+      return;
+
+    int index = y * targetWidth + x;
+    if (depthTest && depth >= zBuffer[index])
+      return;
+
+    float w = 1.0f / v[kInvW];
+    float u = v[kU] * w, tv = v[kV] * w;
+    float remappedU =
+        material.uvMin[0] + u * (material.uvMax[0] - material.uvMin[0]);
+    float remappedV =
+        material.uvMin[1] + tv * (material.uvMax[1] - material.uvMin[1]);
+    Vec3 worldPos(v[kPosX] * w, v[kPosY] * w, v[kPosZ] * w);
+    // Left unnormalized; shadeFragment normalizes after the view transform.
+    Vec3 normal(v[kNormalX] * w, v[kNormalY] * w, v[kNormalZ] * w);
+
+    float lod = 0;
+    if (sampleMips) {
+      const AttributePlane &q = planes[kInvW];
+      float dudx = (planes[kU].dx - u * q.dx) * w * texelsU;
+      float dvdx = (planes[kV].dx - tv * q.dx) * w * texelsV;
+      float dudy = (planes[kU].dy - u * q.dy) * w * texelsU;
+      float dvdy = (planes[kV].dy - tv * q.dy) * w * texelsV;
+      float rho2 = std::max(dudx * dudx + dvdx * dvdx, dudy * dudy + dvdy * dvdy);
+      if (rho2 > 1.0f)
+        lod = 0.5f * fastLog2(rho2);
+    }
+
+    zBuffer[index] = depth;
+    writtenMinZ = std::min(writtenMinZ, depth);
+    writtenMaxZ = std::max(writtenMaxZ, depth);
+    ++writtenCount;
+    if (materialId) {
+      gMaterial[index] = materialId;
+      gNormal[index] = normal;
+      gSurface[index] = Vec3(remappedU, remappedV, lod);
+      return;
+    }
+
+    Vec4 finalColor = shadeFragment(worldPos, Vec3(remappedU, remappedV, lod),
+                                    normal, ctx, material);
+
+    blendPixel(index, packColor(finalColor), blendMode);
   };
 
-  return inside(v0) || inside(v1) || inside(v2);
+  for (int by = blockMinY; by <= maxYInt; by += kRasterBlockSize) {
+    for (int bx = blockMinX; bx <= maxXInt; bx += kRasterBlockSize) {
+
+      // Evaluate every edge at the block pixel that maximises (reject) and
+      // minimises (accept) it.
+      int64_t blockE[3];
+      bool reject = false;
+      bool edgeAccept[3];
+      for (int i = 0; i < 3; ++i) {
+        blockE[i] = originE[i] + stepX[i] * bx + stepY[i] * by;
+        int64_t maxE = blockE[i] + std::max<int64_t>(stepX[i], 0) * blockSpan +
+                       std::max<int64_t>(stepY[i], 0) * blockSpan;
+        int64_t minE = blockE[i] + std::min<int64_t>(stepX[i], 0) * blockSpan +
+                       std::min<int64_t>(stepY[i], 0) * blockSpan;
+        if (maxE < 0) {
+          reject = true;
+          break;
+        }
+        edgeAccept[i] = minE >= 0;
+      }
+      if (reject)
+        continue;
+      bool accept = edgeAccept[0] && edgeAccept[1] && edgeAccept[2];
+
+      // Hierarchical depth: skip the block when the triangle is behind the
+      // farthest stored depth of the tile, and skip per-pixel depth reads
+      // when it is in front of the nearest one.
+      int tileX = bx / kRasterBlockSize, tileY = by / kRasterBlockSize;
+      int tileIndex = tileY * tilesX + tileX;
+      bool depthTest = ctx.enableZBuffer;
+      if (depthTest) {
+        float blockZ = planes[kDepth].at(float(bx - blockMinX),
+                                         float(by - blockMinY));
+        float blockMinZ =
+            std::max(triMinZ, blockZ + std::min(dzdx, 0.0f) * blockSpan +
+                                  std::min(dzdy, 0.0f) * blockSpan);
+        float blockMaxZ =
+            std::min(triMaxZ, blockZ + std::max(dzdx, 0.0f) * blockSpan +
+                                  std::max(dzdy, 0.0f) * blockSpan);
+        if (blockMinZ >= tileMaxDepth[tileIndex])
+          continue;
+        if (blockMaxZ < tileMinDepth[tileIndex]) {
+          depthTest = false;
+        } else if (tileDepthDirty[tileIndex]) {
+          updateTileDepth(tileX, tileY);
+          if (blockMinZ >= tileMaxDepth[tileIndex])
+            continue;
+        }
+      }
+
+      int x0 = std::max(bx, minXInt), x1 = std::min(bx + blockSpan, maxXInt);
+      int y0 = std::max(by, minYInt), y1 = std::min(by + blockSpan, maxYInt);
+      uint32_t columnMask = ((1u << (x1 - x0 + 1)) - 1) << (x0 - bx);
+
+      // Edges crossing the block stay within int32 there unless the
+      // triangle is wide, which falls back to int64 per pixel.
+      const int32_t *offsets[3];
+      for (int i = 0; i < 3; ++i)
+        offsets[i] = edgeAccept[i] ? zeroOffsets : laneOffsets[i];
+
+      writtenMinZ = std::numeric_limits<float>::max();
+      writtenMaxZ = std::numeric_limits<float>::lowest();
+      writtenCount = 0;
+      for (int y = y0; y <= y1; ++y) {
+        int64_t rowE[3];
+        for (int i = 0; i < 3; ++i)
+          rowE[i] = blockE[i] + stepY[i] * (y - by);
+
+        uint32_t mask = columnMask;
+        if (!accept && !wide) {
+          int32_t rowE32[3];
+          for (int i = 0; i < 3; ++i)
+            rowE32[i] = edgeAccept[i] ? 0 : int32_t(rowE[i]);
+          mask &= rowCoverage(rowE32, offsets);
+        } else if (!accept) {
+          for (int lane = 0; lane < kRasterBlockSize; ++lane) {
+            for (int i = 0; i < 3; ++i) {
+              if (rowE[i] + stepX[i] * lane < 0)
+                mask &= ~(1u << lane);
+            }
+          }
+        }
+
+        float varyings[kVaryingCount];
+        for (int k = 0; k < kVaryingCount; ++k)
+          varyings[k] =
+              planes[k].at(float(bx - blockMinX), float(y - blockMinY));
+
+        for (int lane = 0; mask; ++lane, mask >>= 1) {
+          if (mask & 1u)
+            shadePixel(bx + lane, y, varyings, depthTest);
+          for (int k = 0; k < kVaryingCount; ++k)
+            varyings[k] += planes[k].dx;
+        }
+      }
+      // A block that rewrote its whole tile gives exact bounds; otherwise
+      // widen them and let the next Hi-Z test rescan the tile if needed.
+      int tilePixels = (std::min(bx + kRasterBlockSize, targetWidth) - bx) *
+                       (std::min(by + kRasterBlockSize, targetHeight) - by);
+      if (writtenCount == tilePixels) {
+        tileMinDepth[tileIndex] = writtenMinZ;
+        tileMaxDepth[tileIndex] = writtenMaxZ;
+        tileDepthDirty[tileIndex] = 0;
+      } else if (writtenCount > 0) {
+        widenTileDepth(tileIndex, writtenMinZ, writtenMaxZ);
+      }
+    }
+  }
 }
+
 Vec4 SoftwareRenderer::shadeFragment(const Vec3 &worldPos, const Vec3 &uv,
                                      const Vec3 &normal,
                                      const RenderContext &ctx,
@@ -342,15 +1041,13 @@ Vec4 SoftwareRenderer::shadeFragment(const Vec3 &worldPos, const Vec3 &uv,
   Vec4 finalColor = material.baseColor;
 
   if (material.useTexture && material.texture) {
-    uint32_t texColor = material.texture->sample(uv.x, uv.y);
+    uint32_t texColor = material.texture->sampleBilinear(uv.x, uv.y, uv.z);
     finalColor = unpackColor(texColor);
   }
   if (!ctx.enableLighting) {
     return finalColor;
   }
 
-  Vec3 lightDirView =
-      (ctx.viewMatrix * Vec4(lightDir, 0)).toVec3().normalized();
   Vec3 normalView = (ctx.viewMatrix * Vec4(normal, 0)).toVec3().normalized();
   Vec3 viewDir = (ctx.cameraPosition - worldPos).normalized();
 
@@ -369,115 +1066,135 @@ Vec4 SoftwareRenderer::shadeFragment(const Vec3 &worldPos, const Vec3 &uv,
   return finalColor;
 }
 
-void SoftwareRenderer::drawTriangle(const MeshData &mesh,
-                                    const TriangleData &tri, const Mat4 &model,
+void SoftwareRenderer::drawTriangle(const TransformedVertex &t0,
+                                    const TransformedVertex &t1,
+                                    const TransformedVertex &t2,
                                     const RenderContext &ctx,
                                     const MaterialData &material) {
+  const ClippableVertex &v0 = t0.vertex;
+  const ClippableVertex &v1 = t1.vertex;
+  const ClippableVertex &v2 = t2.vertex;
 
-  if (tri.i0 >= mesh.vertices.size() || tri.i1 >= mesh.vertices.size() ||
-      tri.i2 >= mesh.vertices.size()) {
-    std::cerr << "Invalid triangle indices: " << tri.i0 << ", " << tri.i1
-              << ", " << tri.i2
-              << " but vertices count: " << mesh.vertices.size() << "\n";
+  if (outcode(v0.cposition, 1.0f, 1.0f) & outcode(v1.cposition, 1.0f, 1.0f) &
+      outcode(v2.cposition, 1.0f, 1.0f))
     return;
-  }
 
-  Vec4 v0_cam =
-      toCameraSpace(mesh.vertices[tri.i0].position, model, ctx.viewMatrix);
-  Vec4 v1_cam =
-      toCameraSpace(mesh.vertices[tri.i1].position, model, ctx.viewMatrix);
-  Vec4 v2_cam =
-      toCameraSpace(mesh.vertices[tri.i2].position, model, ctx.viewMatrix);
-
-  if (v0_cam.z > 0 && v1_cam.z > 0 && v2_cam.z > 0)
+  if (!isTriangleVisible(v0.cposition, v1.cposition, v2.cposition, material))
     return;
 
-  Vec4 v0_clip = projectToClipSpace(v0_cam, ctx.projectionMatrix);
-  Vec4 v1_clip = projectToClipSpace(v1_cam, ctx.projectionMatrix);
-  Vec4 v2_clip = projectToClipSpace(v2_cam, ctx.projectionMatrix);
-
-  if (!isTriangleVisibleInFrustum(v0_clip, v1_clip, v2_clip))
+  // Only planes some vertex actually crosses are clipped against; x/y use
+  // the guard band so most partially visible triangles skip clipping.
+  float guardX = 1.0f + 2.0f * kGuardBandPixels / targetWidth;
+  float guardY = 1.0f + 2.0f * kGuardBandPixels / targetHeight;
+  uint32_t clipMask = outcode(v0.cposition, guardX, guardY) |
+                      outcode(v1.cposition, guardX, guardY) |
+                      outcode(v2.cposition, guardX, guardY);
+
+  ClipPolygon polygon;
+  int count = 3;
+  if (clipMask) {
+    count = clipTriangle(v0, v1, v2, clipMask, guardX, guardY, polygon);
+  } else {
+    polygon[0] = v0;
+    polygon[1] = v1;
+    polygon[2] = v2;
+  }
+  if (count < 3)
     return;
 
-  auto uvs = fetchUVs(mesh, tri, material);
-  auto ns = fetchNs(mesh, tri, material);
-  auto ps = fetchPs(mesh, tri, material);
-
-  if (ctx.is2DPass || ctx.isOrthographic) {
-    Vec4 v0_screen = ndcToScreen(v0_clip, screenWidth, screenHeight);
-    Vec4 v1_screen = ndcToScreen(v1_clip, screenWidth, screenHeight);
-    Vec4 v2_screen = ndcToScreen(v2_clip, screenWidth, screenHeight);
-
-    std::array<Vec4, 3> vertices = {v0_screen, v1_screen, v2_screen};
-    if (!isTriangleVisible(vertices, material, ctx))
-      return;
+  std::array<Vec4, std::tuple_size<ClipPolygon>::value> screen;
+  for (int i = 0; i < count; ++i)
+    screen[i] = ndcToScreen(polygon[i].cposition, targetWidth, targetHeight);
+
+  for (int i = 1; i + 1 < count; ++i) {
+    std::array<Vec4, 3> vertices = {screen[0], screen[i], screen[i + 1]};
+    if (!isTriangleValid(vertices[0], vertices[1], vertices[2]))
+      continue;
+    std::array<Vec2, 3> uvs = {polygon[0].uv, polygon[i].uv,
+                               polygon[i + 1].uv};
+    std::array<Vec3, 3> ns = {polygon[0].normal, polygon[i].normal,
+                              polygon[i + 1].normal};
+    std::array<Vec3, 3> ps = {polygon[0].position, polygon[i].position,
+                              polygon[i + 1].position};
     rasterizeTriangle(vertices, ps, uvs, ns, ctx, material);
-    return;
-  }
-
-  auto clippedTris = clipTriangleAgainstNearPlane(
-      {v0_clip, ns[0], uvs[0], ps[0]}, {v1_clip, ns[1], uvs[1], ps[1]},
-      {v2_clip, ns[2], uvs[2], ps[2]});
-  for (auto &tri : clippedTris) {
-
-    Vec4 v0_screen = ndcToScreen(tri[0].cposition, screenWidth, screenHeight);
-    Vec4 v1_screen = ndcToScreen(tri[1].cposition, screenWidth, screenHeight);
-    Vec4 v2_screen = ndcToScreen(tri[2].cposition, screenWidth, screenHeight);
-
-    std::array<Vec4, 3> vertices = {v0_screen, v1_screen, v2_screen};
-    if (!isTriangleVisible(vertices, material, ctx))
-      return;
-    std::array<Vec2, 3> nuvs = {tri[0].uv, tri[1].uv, tri[2].uv};
-    std::array<Vec3, 3> nns = {tri[0].normal, tri[1].normal, tri[2].normal};
-    std::array<Vec3, 3> nps = {tri[0].position, tri[1].position,
-                               tri[2].position};
-
-    rasterizeTriangle(vertices, nps, nuvs, nns, ctx, material);
   }
 }
 
-std::vector<std::vector<ClippableVertex>>
-SoftwareRenderer::clipTriangleAgainstNearPlane(const ClippableVertex &v0,
-                                               const ClippableVertex &v1,
-                                               const ClippableVertex &v2) {
-  auto inside = [](const Vec4 &v) { return v.z >= 0.0f && v.z <= v.w; };
-
-  auto intersect = [&](const ClippableVertex &a, const ClippableVertex &b) {
-    float t = (-currentContext->nearPlane - a.cposition.z) /
-              (b.cposition.z - a.cposition.z);
-    return a.lerp(b, t);
-  };
-
-  std::vector<ClippableVertex> verts = {v0, v1, v2};
-  std::vector<ClippableVertex> in, out;
-  for (const auto &v : verts)
-    (inside(v.cposition) ? in : out).push_back(v);
-
-  if (in.size() == 3)
-    return {{{v0, v1, v2}}};
-  if (in.size() == 0)
-    return {};
-
-  if (in.size() == 1) {
-    ClippableVertex i0 = intersect(in[0], out[0]);
-    ClippableVertex i1 = intersect(in[0], out[1]);
-    return {{{in[0], i0, i1}}};
+void SoftwareRenderer::transformVertices(const MeshData &mesh,
+                                         const Mat4 &model,
+                                         const RenderContext &ctx,
+                                         const MaterialData &material) {
+  const Mat4 modelViewProj = ctx.projectionMatrix * (ctx.viewMatrix * model);
+
+  const auto &vertices = mesh.vertices();
+  transformedVertices.resize(vertices.size());
+  for (size_t i = 0; i < vertices.size(); ++i) {
+    const VertexData &src = vertices[i];
+    Vec4 position(src.position, 1.0f);
+
+    TransformedVertex &dst = transformedVertices[i];
+    dst.vertex.cposition = modelViewProj * position;
+    dst.vertex.normal = src.normal;
+    dst.vertex.uv = material.useTexture ? src.uv : Vec2();
+    dst.vertex.position = (model * position).xyz();
   }
+}
 
-  if (in.size() == 2) {
-    ClippableVertex i0 = intersect(in[0], out[0]);
-    ClippableVertex i1 = intersect(in[1], out[0]);
-    return {{{in[0], in[1], i1}}, {in[0], i1, i0}};
+int SoftwareRenderer::clipTriangle(const ClippableVertex &v0,
+                                   const ClippableVertex &v1,
+                                   const ClippableVertex &v2, uint32_t clipMask,
+                                   float guardX, float guardY,
+                                   ClipPolygon &out) const {
+  ClipPolygon scratch;
+  ClipPolygon *src = &out, *dst = &scratch;
+  out[0] = v0;
+  out[1] = v1;
+  out[2] = v2;
+  int count = 3;
+
+  for (uint32_t plane = kClipLeft; plane <= kClipFar && count > 0;
+       plane <<= 1) {
+    if (!(clipMask & plane))
+      continue;
+
+    int outCount = 0;
+    for (int i = 0; i < count; ++i) {
+      const ClippableVertex &a = (*src)[i];
+      const ClippableVertex &b = (*src)[(i + 1) % count];
+      float da = planeDistance(a.cposition, plane, guardX, guardY);
+      float db = planeDistance(b.cposition, plane, guardX, guardY);
+      if (da >= 0)
+        (*dst)[outCount++] = a;
+      if ((da >= 0) != (db >= 0))
+        (*dst)[outCount++] = a.lerp(b, da / (da - db));
+    }
+    std::swap(src, dst);
+    count = outCount;
   }
 
-  return {};
+  if (src != &out)
+    std::copy_n(src->begin(), count, out.begin());
+  return count;
 }
 
 void SoftwareRenderer::renderMesh(const MeshData &mesh, const Mat4 &model,
                                   const MaterialData &material) {
-  for (uint32_t i = 0; i < mesh.indices.size(); i += 3) {
-    TriangleData tri{mesh.indices[i], mesh.indices[i + 1], mesh.indices[i + 2]};
-    drawTriangle(mesh, tri, model, *currentContext, material);
+  activeBlendMode = material.resolvedBlendMode();
+  transformVertices(mesh, model, *rasterContext, material);
+
+  const size_t vertexCount = transformedVertices.size();
+  const auto &indices = mesh.indices();
+  for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+    TriangleData tri{indices[i], indices[i + 1], indices[i + 2]};
+    if (tri.i0 >= vertexCount || tri.i1 >= vertexCount ||
+        tri.i2 >= vertexCount) {
+      std::cerr << "Invalid triangle indices: " << tri.i0 << ", " << tri.i1
+                << ", " << tri.i2 << " but vertices count: " << vertexCount
+                << "\n";
+      continue;
+    }
+    drawTriangle(transformedVertices[tri.i0], transformedVertices[tri.i1],
+                 transformedVertices[tri.i2], *rasterContext, material);
   }
 }
 void SoftwareRenderer::renderMesh(const MeshCommand &meshCommand) {
@@ -491,10 +1208,22 @@ void SoftwareRenderer::submitMesh(const std::shared_ptr<MeshData> mesh,
   if (!activePass) {
     throw std::runtime_error("submitMesh called without active pass!");
   }
+  pinAsset(material.texture);
   MeshCommand meshCommand{mesh, material, model};
   activePass->meshCommands.push_back(meshCommand);
 }
 
+// A pipelined frame rasterizes after the caller may have released its
+// assets, so the pass keeps shared owners of what it points to.
+void SoftwareRenderer::pinAsset(const Asset *asset) {
+  if (!asset)
+    return;
+  std::shared_ptr<const Asset> owner = asset->weak_from_this().lock();
+  auto &pinned = activePass->pinnedAssets;
+  if (owner && (pinned.empty() || pinned.back() != owner))
+    pinned.push_back(std::move(owner));
+}
+
 void SoftwareRenderer::submitSprite(const SpriteData &sprite,
                                     const Mat4 &model) {
 
@@ -510,6 +1239,7 @@ void SoftwareRenderer::submitSprite(const SpriteData &sprite,
   Mat4 scaleMat = Mat4::scale(Vec3(sprite.size[0], sprite.size[1], 1.0f));
   Mat4 finalMat = model * scaleMat;
 
+  pinAsset(mat.texture);
   MeshCommand meshCommand{quadMesh, mat, finalMat};
   activePass->meshCommands.push_back(meshCommand);
 }
@@ -559,7 +1289,7 @@ void SoftwareRenderer::renderText(const UITextDrawCommand &cmd) {
 }
 
 void SoftwareRenderer::flushTextDraws() {
-  for (auto &pass : passes) {
+  for (auto &pass : renderPasses) {
     for (const auto &cmd : pass.textCommands) {
       renderText(cmd);
     }
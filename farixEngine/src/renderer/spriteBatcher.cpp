@@ -0,0 +1,46 @@
+#include "farixEngine/renderer/spriteBatcher.hpp"
+
+namespace farixEngine::renderer {
+
+void SpriteBatcher::clear() {
+  vertices.clear();
+  batches.clear();
+}
+
+void SpriteBatcher::add(uint32_t command, const Mat4 &model,
+                        const Vec2 &uvMin, const Vec2 &uvMax,
+                        const Vec4 &color, const void *texture,
+                        BlendMode blendMode) {
+  if (batches.empty() || batches.back().texture != texture ||
+      batches.back().blendMode != blendMode) {
+    SpriteBatch batch;
+    batch.command = command;
+    batch.texture = texture;
+    batch.blendMode = blendMode;
+    batch.firstQuad = static_cast<uint32_t>(vertices.size() / 4);
+    batches.push_back(batch);
+  }
+  ++batches.back().quadCount;
+
+  // Corners are origin +- half of each axis column, so an affine transform
+  // costs two vector sums per corner.
+  Vec3 origin(model[3][0], model[3][1], model[3][2]);
+  Vec3 halfX = Vec3(model[0][0], model[0][1], model[0][2]) * 0.5f;
+  Vec3 halfY = Vec3(model[1][0], model[1][1], model[1][2]) * 0.5f;
+
+  vertices.push_back({origin - halfX - halfY, Vec2(uvMin.x, uvMin.y), color});
+  vertices.push_back({origin + halfX - halfY, Vec2(uvMax.x, uvMin.y), color});
+  vertices.push_back({origin + halfX + halfY, Vec2(uvMax.x, uvMax.y), color});
+  vertices.push_back({origin - halfX + halfY, Vec2(uvMin.x, uvMax.y), color});
+}
+
+void SpriteBatcher::flush(SpriteBackend &backend) {
+  if (!vertices.empty()) {
+    backend.uploadSpriteVertices(vertices);
+    for (const SpriteBatch &batch : batches)
+      backend.drawSprites(batch);
+  }
+  clear();
+}
+
+} // namespace farixEngine::renderer
@@ -23,6 +23,7 @@ Scene &SceneManager::loadSceneFromFile(const std::string &filePath,
   scene->onLoad();
 
   Serializer::loadScene(scene.get(), filePath);
+  scene->world().buildStaticBatches();
 
   std::cout << "Loaded scene name: '" << scene->name() << "'" << std::endl;
   const std::string name = scene->name();
@@ -61,6 +62,7 @@ World *SceneManager::currentWorld() { return &activeScene->world(); }
 void SceneManager::reloadScene() {
   activeScene->onLoad();
   Serializer::loadScene(activeScene, activeScene->path());
+  activeScene->world().buildStaticBatches();
   //
   std::cout << "Reloaded scene name: '" << activeScene->name() << "'"
             << std::endl;
@@ -18,7 +18,9 @@
 #include "farixEngine/script/script.hpp"
 #include <SDL2/SDL.h>
 #include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <limits>
 namespace farixEngine {
 using Entity = uint32_t;
 
@@ -124,69 +126,143 @@ Vec3 RenderSystem::calculateAnchoredPosition(const RectComponent &rect,
   return offset + pos;
 }
 
+RenderSystem::RenderSystem() : System("RenderSystem") {
+  assetListener = EngineServices::get().getAssetManager().onAssetRemoved(
+      [this](const AssetID &id) {
+        meshCache.erase(id);
+        materialCache.erase(id);
+        // Materials point at their texture asset.
+        materialCache.eraseIf(
+            [&](const AssetID &, const CachedMaterial &material) {
+              return material.data.texture && material.data.texture->id == id;
+            });
+        resolvedMaterials.clear();
+      });
+}
+
+RenderSystem::~RenderSystem() {
+  EngineServices::get().getAssetManager().removeListener(assetListener);
+}
+
 renderer::MeshData RenderSystem::loadMeshFromAsset(AssetID mesh) {
   auto &am = EngineServices::get().getAssetManager();
   renderer::MeshData meshData;
   auto meshAsset = am.get<Mesh>(mesh);
 
-  meshData.vertices.reserve(meshAsset->vertices.size());
-
-  for (const auto &v : meshAsset->vertices) {
-    renderer::VertexData vd;
-    vd.position = v.position;
-    vd.normal = v.normal;
-    vd.uv = v.uv;
-    meshData.vertices.push_back(vd);
-  }
-
-  for (auto &tri : meshAsset->indices) {
-    meshData.indices.push_back(tri);
-  }
+  meshData.uuid = mesh;
+  meshData.version = meshAsset->version;
+  meshData.buffer = meshAsset->buffer;
   return meshData;
 }
 
 std::shared_ptr<renderer::MeshData> RenderSystem::createOrGetMesh(AssetID id) {
-  auto it = meshCache.find(id);
-  if (it != meshCache.end())
-    return it->second;
+  return cachedMesh(id).data;
+}
 
-  auto meshData = std::make_shared<renderer::MeshData>();
+RenderSystem::CachedMesh &RenderSystem::cachedMesh(const AssetID &id) {
+  auto *cached = meshCache.find(id);
+  if (cached && cached->data->version == cached->asset->version)
+    return *cached;
+
+  // A fresh MeshData, so frames already recorded keep the old geometry.
   auto &am = EngineServices::get().getAssetManager();
   auto meshAsset = am.get<Mesh>(id);
+  CachedMesh entry{std::make_shared<renderer::MeshData>(loadMeshFromAsset(id)),
+                   {}, meshAsset.get()};
+  for (size_t level = 0; level < meshAsset->lods.size(); ++level) {
+    auto lod = std::make_shared<renderer::MeshData>();
+    lod->uuid = renderer::lodMeshId(id, level + 1);
+    lod->version = meshAsset->version;
+    lod->buffer = meshAsset->lods[level].buffer;
+    entry.lods.push_back(std::move(lod));
+  }
 
-  meshData->vertices.reserve(meshAsset->vertices.size());
-  for (const auto &v : meshAsset->vertices)
-    meshData->vertices.push_back({v.position, v.normal, v.uv});
-
-  meshData->indices = meshAsset->indices;
+  // The geometry itself belongs to the asset; the entry only pins it.
+  return meshCache.insert(id, std::move(entry), sizeof(CachedMesh));
+}
 
-  meshCache[id] = meshData;
-  return meshData;
+size_t RenderSystem::selectLod(Entity entity, const std::vector<MeshLod> &lods,
+                               float screenSize) {
+  if (lods.empty())
+    return 0;
+  auto levelFor = [&lods](float size) {
+    size_t level = 0;
+    while (level < lods.size() && size < lods[level].screenSize)
+      ++level;
+    return level;
+  };
+
+  // The size has to cross a switch point by kLodHysteresis before the level
+  // changes, so objects resting near one do not flicker between levels.
+  size_t finest = levelFor(screenSize * (1.0f + kLodHysteresis));
+  size_t coarsest = levelFor(screenSize * (1.0f - kLodHysteresis));
+  auto [it, inserted] = lodStates.try_emplace(entity);
+  LodState &state = it->second;
+  state.level = inserted ? levelFor(screenSize)
+                         : std::clamp(state.level, finest, coarsest);
+  state.lastUsed = frame;
+  return state.level;
 }
 renderer::MaterialData &RenderSystem::createOrGetMaterial(AssetID id) {
-  auto it = materialCache.find(id);
-  if (it != materialCache.end())
-    return it->second;
+  return cachedMaterial(id).data;
+}
 
-  auto [newIt, inserted] = materialCache.emplace(id, renderer::MaterialData{});
-  auto &matData = newIt->second;
+RenderSystem::CachedMaterial &RenderSystem::cachedMaterial(const AssetID &id) {
+  if (auto *cached = materialCache.find(id)) {
+    if (cached->version != cached->asset->version) {
+      fillMaterialData(*cached->asset, cached->data);
+      cached->version = cached->asset->version;
+    }
+    return *cached;
+  }
 
   auto &am = EngineServices::get().getAssetManager();
-
   auto matAsset = am.get<Material>(id);
 
-  auto texAsset = am.get<Texture>(matAsset->texture);
+  auto &cached = materialCache.insert(
+      id, {renderer::MaterialData{}, matAsset.get(), matAsset->version},
+      sizeof(CachedMaterial));
+  fillMaterialData(*matAsset, cached.data);
+  return cached;
+}
 
-  matData.baseColor = matAsset->baseColor;
-  matData.ambient = matAsset->ambient;
-  matData.diffuse = matAsset->diffuse;
-  matData.specular = matAsset->specular;
-  matData.shininess = matAsset->shininess;
-  matData.useTexture = matAsset->useTexture;
+void RenderSystem::fillMaterialData(const Material &matAsset,
+                                    renderer::MaterialData &matData) {
+  auto &am = EngineServices::get().getAssetManager();
+  auto texAsset = am.get<Texture>(matAsset.texture);
+
+  matData.baseColor = matAsset.baseColor;
+  matData.ambient = matAsset.ambient;
+  matData.diffuse = matAsset.diffuse;
+  matData.specular = matAsset.specular;
+  matData.shininess = matAsset.shininess;
+  matData.useTexture = matAsset.useTexture;
   matData.texture = texAsset.get();
-  matData.doubleSided = matAsset->doubleSided;
+  matData.doubleSided = matAsset.doubleSided;
+  matData.blendMode = matAsset.blendMode;
+}
 
-  return matData;
+const renderer::MaterialData &
+RenderSystem::resolveMaterial(Entity entity, MaterialComponent &matC) {
+  CachedMaterial &base = cachedMaterial(matC.material);
+  if (!matC.overrideParams) {
+    if (!resolvedMaterials.empty())
+      resolvedMaterials.erase(entity);
+    return base.data;
+  }
+
+  ResolvedMaterial &resolved = resolvedMaterials[entity];
+  resolved.lastUsed = frame;
+  if (resolved.material != matC.material ||
+      resolved.baseVersion != base.version ||
+      resolved.overrides != matC.overrides) {
+    resolved.material = matC.material;
+    resolved.baseVersion = base.version;
+    resolved.overrides = matC.overrides;
+    resolved.data = base.data;
+    applyMaterialOverrides(resolved.data, matC.overrides);
+  }
+  return resolved.data;
 }
 
 void RenderSystem::applyMaterialOverrides(renderer::MaterialData &matData,
@@ -206,6 +282,58 @@ void RenderSystem::applyMaterialOverrides(renderer::MaterialData &matData,
     matData.texture = am.get<Texture>(*overrides.texture).get();
 }
 
+// Drops the per-entity entries the current frame did not touch.
+template <typename Map> void eraseUnused(Map &entries, uint32_t frame) {
+  for (auto it = entries.begin(); it != entries.end();) {
+    if (it->second.lastUsed != frame)
+      it = entries.erase(it);
+    else
+      ++it;
+  }
+}
+
+// Height of the sphere on screen as a fraction of the viewport height.
+float projectedSize(const BoundingSphere &sphere, const CameraComponent &camera,
+                    const Vec3 &cameraPosition) {
+  if (camera.mode == CameraProjectionMode::Orthographic)
+    return 2.0f * sphere.radius / std::abs(camera.orthoTop - camera.orthoBottom);
+
+  float distance = (sphere.center - cameraPosition).length();
+  if (distance <= sphere.radius)
+    return std::numeric_limits<float>::max();
+  return sphere.radius / (distance * std::tan(camera.fov * 0.5f));
+}
+
+void updateWorldBounds(World &world, Entity e, GlobalTransform &global) {
+  StaticBatches &batches = world.getStaticBatches();
+  if (batches.isBatched(e)) {
+    // Bounds were set when the batch was built.
+    if (batches.matches(world, e, global.worldMatrix))
+      return;
+    batches.release(world, e);
+  }
+
+  global.hasBounds = false;
+  SpatialIndex &index = world.getSpatialIndex();
+  if (!world.hasComponent<MeshComponent>(e)) {
+    index.remove(e);
+    return;
+  }
+  const auto &meshC = world.getComponent<MeshComponent>(e);
+  auto mesh = meshC.mesh.empty()
+                  ? nullptr
+                  : EngineServices::get().getAssetManager().get<Mesh>(meshC.mesh);
+  if (!mesh) {
+    index.insertUnbounded(e);
+    return;
+  }
+
+  global.worldBounds = mesh->bounds.transformed(global.worldMatrix);
+  global.worldSphere = mesh->boundingSphere.transformed(global.worldMatrix);
+  global.hasBounds = true;
+  index.update(e, global.worldBounds, global.worldSphere);
+}
+
 void RenderSystem::onUpdate(World &world, float dt) {
   renderer::IRenderer *renderer = EngineServices::get().getContext()->renderer;
   auto &am = EngineServices::get().getAssetManager();
@@ -226,34 +354,65 @@ void RenderSystem::onUpdate(World &world, float dt) {
 
   renderer->beginPass(mainCtx);
 
-  for (Entity entity : world.getEntities()) {
+  // HierarchySystem keeps the index current; seed it when it has not run yet,
+  // on the first frame or after a scene reload.
+  SpatialIndex &index = world.getSpatialIndex();
+  StaticBatches &staticBatches = world.getStaticBatches();
+  if (index.size() == 0 && staticBatches.memberCount() == 0) {
+    for (Entity entity : world.getEntities()) {
+      if (world.hasComponent<GlobalTransform>(entity) &&
+          world.hasComponent<MeshComponent>(entity))
+        updateWorldBounds(world, entity,
+                          world.getComponent<GlobalTransform>(entity));
+    }
+  }
+
+  const Frustum frustum =
+      Frustum::fromMatrix(mainCtx.projectionMatrix * mainCtx.viewMatrix);
+  visibleMeshes.clear();
+  index.query(frustum, visibleMeshes);
+  // Submit in creation order, as a walk over the entity list would.
+  std::sort(visibleMeshes.begin(), visibleMeshes.end());
+
+  for (Entity entity : visibleMeshes) {
     if (world.hasComponent<GlobalTransform>(entity) &&
         world.hasComponent<MeshComponent>(entity) &&
         world.hasComponent<MaterialComponent>(entity)) {
 
-      const Mat4 &model =
-          world.getComponent<GlobalTransform>(entity).worldMatrix;
+      const auto &global = world.getComponent<GlobalTransform>(entity);
       auto &meshC = world.getComponent<MeshComponent>(entity);
       auto &matC = world.getComponent<MaterialComponent>(entity);
 
       if (meshC.mesh.empty() || matC.material.empty())
         continue;
 
-      std::shared_ptr<renderer::MeshData> meshData =
-          createOrGetMesh(meshC.mesh);
-      meshData->uuid = meshC.mesh;
-      renderer::MaterialData *matDataPtr = &createOrGetMaterial(matC.material);
-
-      if (matC.overrideParams) {
+      CachedMesh &mesh = cachedMesh(meshC.mesh);
+      size_t level =
+          global.hasBounds
+              ? selectLod(entity, mesh.asset->lods,
+                          projectedSize(global.worldSphere, camera,
+                                        cameraPosition))
+              : 0;
+      renderer->submitMesh(level == 0 ? mesh.data : mesh.lods[level - 1],
+                           global.worldMatrix, resolveMaterial(entity, matC));
+    }
+  }
 
-        renderer::MaterialData matDataCopy = *matDataPtr;
-        applyMaterialOverrides(matDataCopy, matC.overrides);
-        renderer->submitMesh(meshData, model, matDataCopy);
-      } else {
+  eraseUnused(resolvedMaterials, frame);
+  eraseUnused(lodStates, frame);
+  ++frame;
+
+  for (const std::string &id : staticBatches.takeRetiredMeshes())
+    renderer->releaseAsset(id);
+  visibleBatches.clear();
+  staticBatches.query(frustum, visibleBatches);
+  for (uint32_t index : visibleBatches) {
+    const StaticBatches::Batch &batch = staticBatches.batch(index);
+    renderer->submitMesh(batch.mesh, Mat4::identity(),
+                         createOrGetMaterial(batch.material));
+  }
 
-        renderer->submitMesh(meshData, model, *matDataPtr);
-      }
-    }
+  for (Entity entity : world.getEntities()) {
 
     if (world.hasComponent<GlobalTransform>(entity) &&
         world.hasComponent<Sprite2DComponent>(entity)) {
@@ -387,7 +546,9 @@ void processEntity(World &world, Entity e, const Mat4 &parentMatrix) {
   Mat4 localMat = Mat4::modelMatrix(local);
 
   Mat4 globalMat = parentMatrix * localMat;
-  world.getComponent<GlobalTransform>(e).worldMatrix = globalMat;
+  auto &global = world.getComponent<GlobalTransform>(e);
+  global.worldMatrix = globalMat;
+  updateWorldBounds(world, e, global);
 
   for (Entity child : world.getChildren(e)) {
     processEntity(world, child, globalMat);
@@ -401,6 +562,8 @@ void HierarchySystem::onUpdate(World &world, float dt) {
       processEntity(world, e, Mat4::identity());
     }
   }
+  world.getStaticBatches().update(world);
+  world.getSpatialIndex().endFrame();
 }
 
 void CameraControllerSystem::onUpdate(World &world, float dt) {
@@ -0,0 +1,75 @@
+#include "farixEngine/utils/threadPool.hpp"
+
+namespace farixEngine::utils {
+
+ThreadPool::ThreadPool(unsigned workerCount) {
+  workers.reserve(workerCount);
+  for (unsigned i = 0; i < workerCount; ++i)
+    workers.emplace_back([this] { workerLoop(); });
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  wake.notify_all();
+  for (auto &worker : workers)
+    worker.join();
+}
+
+unsigned ThreadPool::defaultWorkerCount() {
+  unsigned hardware = std::thread::hardware_concurrency();
+  return hardware > 1 ? hardware - 1 : 0;
+}
+
+void ThreadPool::parallelFor(int count, const std::function<void(int)> &fn) {
+  if (count <= 0)
+    return;
+  if (workers.empty() || count == 1) {
+    for (int i = 0; i < count; ++i)
+      fn(i);
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    job = &fn;
+    jobCount = count;
+    nextIndex.store(0, std::memory_order_relaxed);
+    busyWorkers = workers.size();
+    ++generation;
+  }
+  wake.notify_all();
+
+  runJob();
+
+  std::unique_lock<std::mutex> lock(mutex);
+  done.wait(lock, [this] { return busyWorkers == 0; });
+  job = nullptr;
+}
+
+void ThreadPool::runJob() {
+  for (int i = nextIndex.fetch_add(1); i < jobCount; i = nextIndex.fetch_add(1))
+    (*job)(i);
+}
+
+void ThreadPool::workerLoop() {
+  uint64_t seen = 0;
+  std::unique_lock<std::mutex> lock(mutex);
+  while (true) {
+    wake.wait(lock, [&] { return stopping || generation != seen; });
+    if (stopping)
+      return;
+    seen = generation;
+
+    lock.unlock();
+    runJob();
+    lock.lock();
+
+    if (--busyWorkers == 0)
+      done.notify_one();
+  }
+}
+
+} // namespace farixEngine::utils
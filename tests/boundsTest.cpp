@@ -0,0 +1,115 @@
+#include "check.hpp"
+
+#include "farixEngine/assets/mesh.hpp"
+#include "farixEngine/math/bounds.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+using namespace farixEngine;
+
+namespace {
+
+bool near(float a, float b, float epsilon = 1e-4f) {
+  return std::abs(a - b) <= epsilon;
+}
+
+bool near(const Vec3 &a, const Vec3 &b, float epsilon = 1e-4f) {
+  return near(a.x, b.x, epsilon) && near(a.y, b.y, epsilon) &&
+         near(a.z, b.z, epsilon);
+}
+
+void boxBounds() {
+  auto box = Mesh::createBox(2.0f, 4.0f, 6.0f);
+  CHECK(near(box->bounds.min, Vec3(-1.0f, -2.0f, -3.0f)));
+  CHECK(near(box->bounds.max, Vec3(1.0f, 2.0f, 3.0f)));
+  CHECK(near(box->boundingSphere.center, Vec3(0.0f)));
+  CHECK(near(box->boundingSphere.radius, std::sqrt(14.0f)));
+}
+
+void sphereBounds() {
+  auto sphere = Mesh::createSphere(1.5f, 16, 32);
+  CHECK(near(sphere->bounds.min, Vec3(-1.5f), 1e-3f));
+  CHECK(near(sphere->bounds.max, Vec3(1.5f), 1e-3f));
+  CHECK(near(sphere->boundingSphere.radius, 1.5f, 1e-3f));
+}
+
+void offCentreBounds() {
+  Mesh mesh;
+  mesh.setGeometry({{Vec3(1, 1, 1), Vec3(0, 0, 1), Vec2(0, 0)},
+                    {Vec3(3, 1, 1), Vec3(0, 0, 1), Vec2(0, 0)},
+                    {Vec3(1, 5, 1), Vec3(0, 0, 1), Vec2(0, 0)}},
+                   {0, 1, 2});
+  CHECK(near(mesh.bounds.min, Vec3(1, 1, 1)));
+  CHECK(near(mesh.bounds.max, Vec3(3, 5, 1)));
+  // Centred on the box, reaching the farthest vertex.
+  CHECK(near(mesh.boundingSphere.center, Vec3(2, 3, 1)));
+  CHECK(near(mesh.boundingSphere.radius, std::sqrt(5.0f)));
+
+  mesh.setGeometry({}, {});
+  CHECK(near(mesh.bounds.min, Vec3(0.0f)));
+  CHECK(near(mesh.boundingSphere.radius, 0.0f));
+}
+
+Frustum cameraFrustum() {
+  Mat4 view = Mat4::lookAt(Vec3(0, 0, 10), Vec3(0), Vec3(0, 1, 0));
+  Mat4 proj = Mat4::perspective(1.0f, 16.0f / 9.0f, 0.1f, 50.0f);
+  return Frustum::fromMatrix(proj * view);
+}
+
+void knownSpheres() {
+  Frustum frustum = cameraFrustum();
+  CHECK(frustum.intersects(BoundingSphere{Vec3(0), 1.0f}));
+  // Behind the camera and beyond the far plane.
+  CHECK(!frustum.intersects(BoundingSphere{Vec3(0, 0, 12), 1.0f}));
+  CHECK(!frustum.intersects(BoundingSphere{Vec3(0, 0, -45), 1.0f}));
+  // Centre outside the right plane, radius reaching back in.
+  CHECK(!frustum.intersects(BoundingSphere{Vec3(20, 0, 0), 1.0f}));
+  CHECK(frustum.intersects(BoundingSphere{Vec3(20, 0, 0), 15.0f}));
+}
+
+void batchedCullingMatchesScalar() {
+  Frustum frustum = cameraFrustum();
+
+  // An odd count exercises the scalar tail after the SIMD lanes.
+  SphereBatch batch;
+  std::vector<BoundingSphere> spheres;
+  uint32_t state = 12345;
+  auto next = [&state](float lo, float hi) {
+    state = state * 1664525u + 1013904223u;
+    return lo + (hi - lo) * float(state >> 8) / float(1u << 24);
+  };
+  for (int i = 0; i < 1003; ++i) {
+    BoundingSphere sphere{
+        Vec3(next(-40, 40), next(-40, 40), next(-60, 20)), next(0, 4)};
+    spheres.push_back(sphere);
+    batch.push(sphere);
+  }
+
+  std::vector<uint8_t> visible;
+  frustum.cullSpheres(batch, visible);
+  CHECK_EQ(visible.size(), spheres.size());
+  if (visible.size() != spheres.size())
+    return;
+
+  int mismatched = 0, inside = 0;
+  for (size_t i = 0; i < spheres.size(); ++i) {
+    mismatched += (visible[i] != 0) != frustum.intersects(spheres[i]);
+    inside += visible[i] != 0;
+  }
+  CHECK_EQ(mismatched, 0);
+  // Both outcomes are exercised.
+  CHECK(inside > 0 && inside < int(spheres.size()));
+}
+
+} // namespace
+
+int main() {
+  boxBounds();
+  sphereBounds();
+  offCentreBounds();
+  knownSpheres();
+  batchedCullingMatchesScalar();
+  return TEST_RESULT();
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <iostream>
+
+// Minimal assertions for the engine's test executables: a failed check is
+// reported and makes main() return non-zero.
+namespace farixTest {
+inline int &failures() {
+  static int count = 0;
+  return count;
+}
+} // namespace farixTest
+
+#define CHECK(cond)                                                            \
+  do {                                                                         \
+    if (!(cond)) {                                                             \
+      std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK(" #cond ") failed\n"; \
+      ++farixTest::failures();                                                 \
+    }                                                                          \
+  } while (0)
+
+#define CHECK_EQ(a, b)                                                         \
+  do {                                                                         \
+    auto checkA = (a);                                                         \
+    auto checkB = (b);                                                         \
+    if (!(checkA == checkB)) {                                                 \
+      std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK_EQ(" #a ", " #b     \
+                << ") failed: " << checkA << " != " << checkB << "\n";         \
+      ++farixTest::failures();                                                 \
+    }                                                                          \
+  } while (0)
+
+#define TEST_RESULT() (farixTest::failures() == 0 ? 0 : 1)
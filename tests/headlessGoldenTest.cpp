@@ -0,0 +1,113 @@
+#include "check.hpp"
+
+#include "farixEngine/assets/mesh.hpp"
+#include "farixEngine/renderer/headless/headlessRenderer.hpp"
+
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace farixEngine;
+using namespace farixEngine::renderer;
+
+// Renders a small lit scene without a window and compares it against
+// golden/headlessScene.ppm. Pass --update to rewrite the reference after an
+// intentional change to the rasterizer's output.
+
+namespace {
+
+const int kWidth = 96;
+const int kHeight = 64;
+const int kChannelTolerance = 2;
+const std::string kGoldenPath =
+    std::string(FARIX_TEST_DATA_DIR) + "/headlessScene.ppm";
+
+std::shared_ptr<MeshData> toMeshData(const Mesh &mesh) {
+  auto data = std::make_shared<MeshData>();
+  data->buffer = mesh.buffer;
+  return data;
+}
+
+void renderScene(HeadlessRenderer &renderer) {
+  RenderContext ctx;
+  ctx.cameraPosition = Vec3(0.0f, 1.2f, 3.0f);
+  ctx.viewMatrix = Mat4::lookAt(ctx.cameraPosition, Vec3(0.0f),
+                                Vec3(0.0f, 1.0f, 0.0f));
+  ctx.projectionMatrix = Mat4::perspective(
+      0.8f, static_cast<float>(kWidth) / kHeight, ctx.nearPlane, ctx.farPlane);
+
+  auto box = toMeshData(*Mesh::createBox(1.0f, 1.0f, 1.0f));
+  auto sphere = toMeshData(*Mesh::createSphere(0.6f, 12, 16));
+
+  MaterialData red;
+  red.baseColor = Vec4(0.9f, 0.2f, 0.2f, 1.0f);
+  MaterialData blue;
+  blue.baseColor = Vec4(0.2f, 0.3f, 0.9f, 1.0f);
+
+  renderer.beginFrame();
+  renderer.beginPass(ctx);
+  renderer.submitMesh(box, Mat4::translate(Vec3(-0.6f, 0.0f, 0.0f)) *
+                               Mat4::rotateY(0.6f),
+                      red);
+  renderer.submitMesh(sphere, Mat4::translate(Vec3(0.5f, 0.1f, 0.4f)), blue);
+  renderer.endPass();
+  renderer.endFrame();
+}
+
+bool loadPPM(const std::string &path, int &width, int &height,
+             std::vector<uint8_t> &rgb) {
+  std::ifstream file(path, std::ios::binary);
+  std::string magic;
+  int maxValue = 0;
+  if (!(file >> magic >> width >> height >> maxValue) || magic != "P6" ||
+      maxValue != 255)
+    return false;
+  file.get();
+  rgb.resize(static_cast<size_t>(width) * height * 3);
+  file.read(reinterpret_cast<char *>(rgb.data()), rgb.size());
+  return static_cast<size_t>(file.gcount()) == rgb.size();
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  HeadlessRenderer renderer(kWidth, kHeight);
+  renderScene(renderer);
+  CHECK_EQ(renderer.getFrameCount(), 1u);
+
+  if (argc > 1 && std::string(argv[1]) == "--update") {
+    CHECK(renderer.savePPM(kGoldenPath));
+    return TEST_RESULT();
+  }
+
+  int width = 0, height = 0;
+  std::vector<uint8_t> golden;
+  if (!loadPPM(kGoldenPath, width, height, golden)) {
+    std::cerr << "Missing or unreadable golden image " << kGoldenPath << "\n";
+    return 1;
+  }
+  CHECK_EQ(width, kWidth);
+  CHECK_EQ(height, kHeight);
+  if (width != kWidth || height != kHeight)
+    return TEST_RESULT();
+
+  int mismatched = 0;
+  for (int y = 0; y < kHeight; ++y) {
+    for (int x = 0; x < kWidth; ++x) {
+      uint32_t c = renderer.readPixel(x, y);
+      const uint8_t *g = &golden[(y * kWidth + x) * 3];
+      int dr = std::abs(static_cast<int>((c >> 16) & 0xFF) - g[0]);
+      int dg = std::abs(static_cast<int>((c >> 8) & 0xFF) - g[1]);
+      int db = std::abs(static_cast<int>(c & 0xFF) - g[2]);
+      if (dr > kChannelTolerance || dg > kChannelTolerance ||
+          db > kChannelTolerance)
+        ++mismatched;
+    }
+  }
+  CHECK_EQ(mismatched, 0);
+
+  if (mismatched)
+    renderer.savePPM("headlessScene.actual.ppm");
+  return TEST_RESULT();
+}
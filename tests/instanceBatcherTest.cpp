@@ -0,0 +1,147 @@
+#include "check.hpp"
+
+#include "farixEngine/renderer/instanceBatcher.hpp"
+
+using namespace farixEngine;
+using namespace farixEngine::renderer;
+
+namespace {
+
+// Stand-ins for mesh identities; only their addresses matter.
+int meshA;
+int meshB;
+
+InstanceKey keyFor(const void *mesh) {
+  InstanceKey key;
+  key.mesh = mesh;
+  return key;
+}
+
+// Tags each instance with its command index so packing can be traced.
+void add(InstanceBatcher &batcher, uint32_t command, const void *mesh,
+         bool ordered) {
+  batcher.add(command, keyFor(mesh), Mat4::translate(Vec3(float(command))),
+              Vec4(float(command), 0.0f, 0.0f, 1.0f), ordered);
+}
+
+bool sameBatch(const InstanceBatch &batch, uint32_t command,
+               uint32_t firstInstance, uint32_t instanceCount) {
+  return batch.command == command && batch.firstInstance == firstInstance &&
+         batch.instanceCount == instanceCount;
+}
+
+void unorderedMergeAcrossPass() {
+  InstanceBatcher batcher;
+  RecordingInstanceBackend backend;
+  add(batcher, 0, &meshA, false);
+  add(batcher, 1, &meshB, false);
+  add(batcher, 2, &meshA, false);
+  add(batcher, 3, &meshB, false);
+  add(batcher, 4, &meshA, false);
+  CHECK_EQ(batcher.batchCount(), size_t(2));
+  batcher.flush(backend);
+
+  CHECK_EQ(backend.uploads.size(), size_t(1));
+  CHECK_EQ(backend.draws.size(), size_t(2));
+  if (backend.uploads.size() != 1 || backend.draws.size() != 2)
+    return;
+  CHECK(sameBatch(backend.draws[0], 0, 0, 3));
+  CHECK(sameBatch(backend.draws[1], 1, 3, 2));
+
+  // Each batch's instances are contiguous and keep submission order.
+  const std::vector<InstanceData> &packed = backend.uploads[0];
+  const float expected[] = {0, 2, 4, 1, 3};
+  CHECK_EQ(packed.size(), size_t(5));
+  for (size_t i = 0; i < packed.size() && i < 5; ++i) {
+    CHECK_EQ(packed[i].color.x, expected[i]);
+    CHECK_EQ(packed[i].model[3][0], expected[i]);
+  }
+}
+
+void orderedOnlyExtendsPreviousBatch() {
+  InstanceBatcher batcher;
+  RecordingInstanceBackend backend;
+  add(batcher, 0, &meshA, true);
+  add(batcher, 1, &meshA, true);
+  add(batcher, 2, &meshB, true);
+  add(batcher, 3, &meshA, true);
+  batcher.flush(backend);
+
+  CHECK_EQ(backend.draws.size(), size_t(3));
+  if (backend.draws.size() != 3)
+    return;
+  CHECK(sameBatch(backend.draws[0], 0, 0, 2));
+  CHECK(sameBatch(backend.draws[1], 2, 2, 1));
+  CHECK(sameBatch(backend.draws[2], 3, 3, 1));
+}
+
+void orderedAndUnorderedStayApart() {
+  InstanceBatcher batcher;
+  RecordingInstanceBackend backend;
+  add(batcher, 0, &meshA, false);
+  add(batcher, 1, &meshA, true);
+  add(batcher, 2, &meshA, false);
+  add(batcher, 3, &meshA, true);
+  batcher.flush(backend);
+
+  // The unordered draw rejoins its group; the second ordered draw cannot
+  // extend the first across it.
+  CHECK_EQ(backend.draws.size(), size_t(3));
+  CHECK_EQ(backend.uploads.size(), size_t(1));
+  if (backend.draws.size() != 3 || backend.uploads.size() != 1)
+    return;
+  CHECK(sameBatch(backend.draws[0], 0, 0, 2));
+  CHECK(sameBatch(backend.draws[1], 1, 2, 1));
+  CHECK(sameBatch(backend.draws[2], 3, 3, 1));
+  const std::vector<InstanceData> &packed = backend.uploads[0];
+  const float expected[] = {0, 2, 1, 3};
+  CHECK_EQ(packed.size(), size_t(4));
+  for (size_t i = 0; i < packed.size() && i < 4; ++i)
+    CHECK_EQ(packed[i].color.x, expected[i]);
+}
+
+void keyFieldsSplitBatches() {
+  InstanceBatcher batcher;
+  RecordingInstanceBackend backend;
+  InstanceKey opaque = keyFor(&meshA);
+  InstanceKey shiny = opaque;
+  shiny.shininess = 64.0f;
+  InstanceKey textured = opaque;
+  textured.useTexture = true;
+  for (const InstanceKey &key : {opaque, shiny, textured, opaque})
+    batcher.add(0, key, Mat4::identity(), Vec4(1.0f, 1.0f, 1.0f, 1.0f), false);
+  batcher.flush(backend);
+  CHECK_EQ(backend.draws.size(), size_t(3));
+}
+
+void flushClearsThePass() {
+  InstanceBatcher batcher;
+  RecordingInstanceBackend backend;
+  add(batcher, 0, &meshA, false);
+  batcher.flush(backend);
+  CHECK_EQ(batcher.instanceCount(), size_t(0));
+  CHECK_EQ(batcher.batchCount(), size_t(0));
+
+  backend.clear();
+  batcher.flush(backend);
+  CHECK(backend.uploads.empty());
+  CHECK(backend.draws.empty());
+
+  // Groups from the previous pass are gone: this one starts at command 5.
+  add(batcher, 5, &meshA, false);
+  batcher.flush(backend);
+  CHECK_EQ(backend.draws.size(), size_t(1));
+  if (!backend.draws.empty())
+    CHECK(sameBatch(backend.draws[0], 5, 0, 1));
+}
+
+} // namespace
+
+int main() {
+  unorderedMergeAcrossPass();
+  orderedOnlyExtendsPreviousBatch();
+  orderedAndUnorderedStayApart();
+  keyFieldsSplitBatches();
+  flushClearsThePass();
+  return TEST_RESULT();
+}
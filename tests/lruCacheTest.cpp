@@ -0,0 +1,132 @@
+#include "check.hpp"
+
+#include "farixEngine/utils/lruCache.hpp"
+
+#include <string>
+#include <vector>
+
+using namespace farixEngine::utils;
+
+namespace {
+
+using Cache = LRUCache<std::string, int>;
+
+struct Released {
+  std::vector<std::string> keys;
+
+  void attach(Cache &cache) {
+    cache.setReleaseCallback(
+        [this](const std::string &key, int &) { keys.push_back(key); });
+  }
+};
+
+void evictsLeastRecentlyUsedToFitBudget() {
+  Cache cache(100);
+  Released released;
+  released.attach(cache);
+
+  cache.insert("a", 1, 40);
+  cache.insert("b", 2, 40);
+  // Touching "a" leaves "b" as the oldest entry.
+  CHECK(cache.find("a") != nullptr);
+  cache.insert("c", 3, 40);
+
+  CHECK(released.keys == std::vector<std::string>{"b"});
+  CHECK(cache.contains("a"));
+  CHECK(!cache.contains("b"));
+  CHECK(cache.contains("c"));
+  CHECK_EQ(cache.bytes(), size_t(80));
+
+  CacheStats stats = cache.stats();
+  CHECK_EQ(stats.hits, uint64_t(1));
+  CHECK_EQ(stats.evictions, uint64_t(1));
+  CHECK_EQ(stats.entries, size_t(2));
+  CHECK(cache.find("b") == nullptr);
+  CHECK_EQ(cache.stats().misses, uint64_t(1));
+}
+
+void evictsInRecencyOrder() {
+  Cache cache(1000);
+  Released released;
+  released.attach(cache);
+
+  for (const char *key : {"a", "b", "c", "d"})
+    cache.insert(key, 0, 10);
+  cache.find("b");
+  cache.find("a");
+
+  // Shrinking the budget evicts from the least recently used end.
+  cache.setBudget(20);
+  CHECK((released.keys == std::vector<std::string>{"c", "d"}));
+  CHECK_EQ(cache.stats().evictions, uint64_t(2));
+
+  cache.setBudget(10);
+  CHECK((released.keys == std::vector<std::string>{"c", "d", "b"}));
+  CHECK(cache.contains("a"));
+}
+
+void keepsAnOversizedNewEntry() {
+  Cache cache(50);
+  Released released;
+  released.attach(cache);
+
+  cache.insert("small", 1, 10);
+  int &big = cache.insert("big", 2, 80);
+  CHECK_EQ(big, 2);
+  CHECK(released.keys == std::vector<std::string>{"small"});
+  CHECK(cache.contains("big"));
+  CHECK_EQ(cache.bytes(), size_t(80));
+}
+
+void overwriteReleasesTheOldValue() {
+  Cache cache;
+  std::vector<int> releasedValues;
+  cache.setReleaseCallback(
+      [&](const std::string &, int &value) { releasedValues.push_back(value); });
+
+  cache.insert("a", 1, 10);
+  cache.insert("a", 2, 30);
+  CHECK(releasedValues == std::vector<int>{1});
+  CHECK_EQ(*cache.find("a"), 2);
+  CHECK_EQ(cache.bytes(), size_t(30));
+  CHECK_EQ(cache.size(), size_t(1));
+}
+
+void eraseIfReleasesMatchingEntries() {
+  Cache cache;
+  Released released;
+  released.attach(cache);
+
+  cache.insert("a", 1, 10);
+  cache.insert("b", 2, 20);
+  cache.insert("c", 3, 30);
+  cache.insert("d", 4, 40);
+
+  size_t erased =
+      cache.eraseIf([](const std::string &, int value) { return value % 2; });
+  CHECK_EQ(erased, size_t(2));
+  CHECK_EQ(released.keys.size(), size_t(2));
+  CHECK(!cache.contains("a") && !cache.contains("c"));
+  CHECK(cache.contains("b") && cache.contains("d"));
+  CHECK_EQ(cache.bytes(), size_t(60));
+  // Explicit removal is not an eviction.
+  CHECK_EQ(cache.stats().evictions, uint64_t(0));
+
+  CHECK(cache.erase("b"));
+  CHECK(!cache.erase("b"));
+  cache.clear();
+  CHECK_EQ(released.keys.size(), size_t(4));
+  CHECK_EQ(cache.size(), size_t(0));
+  CHECK_EQ(cache.bytes(), size_t(0));
+}
+
+} // namespace
+
+int main() {
+  evictsLeastRecentlyUsedToFitBudget();
+  evictsInRecencyOrder();
+  keepsAnOversizedNewEntry();
+  overwriteReleasesTheOldValue();
+  eraseIfReleasesMatchingEntries();
+  return TEST_RESULT();
+}
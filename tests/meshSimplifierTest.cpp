@@ -0,0 +1,218 @@
+#include "check.hpp"
+
+#include "farixEngine/assets/meshSimplifier.hpp"
+
+#include <cmath>
+#include <map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+using namespace farixEngine;
+
+namespace {
+
+// Welded UV sphere: poles and the longitude seam share vertices, so the
+// surface is closed and has no seams.
+MeshBuffer closedSphere(int rings, int segments) {
+  MeshBuffer mesh;
+  auto add = [&mesh](const Vec3 &p) {
+    mesh.vertices.push_back({p, p, Vec2(0, 0)});
+    return uint32_t(mesh.vertices.size() - 1);
+  };
+  uint32_t north = add(Vec3(0, 1, 0));
+  for (int r = 1; r < rings; ++r) {
+    float theta = 3.14159265f * r / rings;
+    for (int s = 0; s < segments; ++s) {
+      float phi = 6.2831853f * s / segments;
+      add(Vec3(std::sin(theta) * std::cos(phi), std::cos(theta),
+               std::sin(theta) * std::sin(phi)));
+    }
+  }
+  uint32_t south = add(Vec3(0, -1, 0));
+
+  auto at = [segments](int ring, int s) {
+    return uint32_t(1 + (ring - 1) * segments + (s % segments));
+  };
+  for (int s = 0; s < segments; ++s) {
+    mesh.indices.insert(mesh.indices.end(), {north, at(1, s + 1), at(1, s)});
+    for (int r = 1; r < rings - 1; ++r) {
+      mesh.indices.insert(mesh.indices.end(),
+                          {at(r, s), at(r, s + 1), at(r + 1, s + 1)});
+      mesh.indices.insert(mesh.indices.end(),
+                          {at(r, s), at(r + 1, s + 1), at(r + 1, s)});
+    }
+    mesh.indices.insert(mesh.indices.end(),
+                        {south, at(rings - 1, s), at(rings - 1, s + 1)});
+  }
+  return mesh;
+}
+
+// Flat n x n grid in the z = 0 plane, facing +z. With a seam, the right half
+// is a separate UV island starting at u = 2, so the column at x = n / 2 is
+// duplicated.
+MeshBuffer grid(int n, bool seam) {
+  MeshBuffer mesh;
+  std::map<std::pair<int, int>, uint32_t> left, right;
+  for (int y = 0; y <= n; ++y) {
+    for (int x = 0; x <= n; ++x) {
+      Vec3 p(float(x), float(y), 0.0f);
+      Vec2 uv(float(x) / n, float(y) / n);
+      bool island = seam && x > n / 2;
+      if (island)
+        uv.x += 2.0f;
+      (island ? right : left)[{x, y}] = uint32_t(mesh.vertices.size());
+      mesh.vertices.push_back({p, Vec3(0, 0, 1), uv});
+      if (seam && x == n / 2) {
+        right[{x, y}] = uint32_t(mesh.vertices.size());
+        mesh.vertices.push_back({p, Vec3(0, 0, 1), Vec2(uv.x + 2.0f, uv.y)});
+      }
+    }
+  }
+  auto at = [&](int x, int y, bool rightHalf) {
+    if (rightHalf || !left.count({x, y}))
+      return right[{x, y}];
+    return left[{x, y}];
+  };
+  for (int y = 0; y < n; ++y) {
+    for (int x = 0; x < n; ++x) {
+      bool r = seam && x >= n / 2;
+      uint32_t a = at(x, y, r), b = at(x + 1, y, r), c = at(x, y + 1, r),
+               d = at(x + 1, y + 1, r);
+      mesh.indices.insert(mesh.indices.end(), {a, b, d, a, d, c});
+    }
+  }
+  return mesh;
+}
+
+Vec3 faceNormal(const MeshBuffer &mesh, size_t i) {
+  const Vec3 &a = mesh.vertices[mesh.indices[i]].position;
+  const Vec3 &b = mesh.vertices[mesh.indices[i + 1]].position;
+  const Vec3 &c = mesh.vertices[mesh.indices[i + 2]].position;
+  return (b - a).cross(c - a);
+}
+
+int verticesNotInInput(const MeshBuffer &source, const MeshBuffer &result) {
+  std::unordered_set<Vertex> input(source.vertices.begin(),
+                                   source.vertices.end());
+  int foreign = 0;
+  for (const Vertex &v : result.vertices)
+    foreign += input.count(v) == 0;
+  return foreign;
+}
+
+bool indicesInRange(const MeshBuffer &mesh) {
+  for (uint32_t index : mesh.indices)
+    if (index >= mesh.vertices.size())
+      return false;
+  return mesh.indices.size() % 3 == 0;
+}
+
+void closedMeshReachesTarget() {
+  MeshBuffer sphere = closedSphere(24, 48);
+  size_t target = sphere.indices.size() / 4 / 3 * 3;
+  MeshBuffer result = simplifyMesh(sphere, target, 1.0f);
+
+  CHECK(indicesInRange(result));
+  CHECK(result.indices.size() <= target);
+  CHECK(result.indices.size() >= target / 2);
+  CHECK_EQ(verticesNotInInput(sphere, result), 0);
+
+  int inverted = 0, degenerate = 0;
+  for (size_t i = 0; i < result.indices.size(); i += 3) {
+    Vec3 n = faceNormal(result, i);
+    Vec3 centroid = (result.vertices[result.indices[i]].position +
+                     result.vertices[result.indices[i + 1]].position +
+                     result.vertices[result.indices[i + 2]].position) *
+                    (1.0f / 3.0f);
+    degenerate += n.length() < 1e-6f;
+    inverted += n.dot(centroid) <= 0.0f;
+  }
+  CHECK_EQ(degenerate, 0);
+  CHECK_EQ(inverted, 0);
+}
+
+void borderStaysInPlace() {
+  const int n = 24;
+  MeshBuffer plane = grid(n, false);
+  MeshBuffer result = simplifyMesh(plane, 3 * 60, 1.0f);
+
+  CHECK(indicesInRange(result));
+  CHECK(result.indices.size() < plane.indices.size() / 4);
+  CHECK_EQ(verticesNotInInput(plane, result), 0);
+
+  // Edges used by a single triangle form the outline, which must still be
+  // the full square.
+  std::map<std::pair<uint32_t, uint32_t>, int> edges;
+  float area = 0.0f;
+  int flipped = 0;
+  for (size_t i = 0; i < result.indices.size(); i += 3) {
+    for (int k = 0; k < 3; ++k) {
+      uint32_t a = result.indices[i + k];
+      uint32_t b = result.indices[i + (k + 1) % 3];
+      ++edges[{std::min(a, b), std::max(a, b)}];
+    }
+    Vec3 normal = faceNormal(result, i);
+    flipped += normal.z <= 0.0f;
+    area += normal.z * 0.5f;
+  }
+  float outline = 0.0f;
+  for (const auto &[edge, uses] : edges) {
+    if (uses == 1)
+      outline += (result.vertices[edge.first].position -
+                  result.vertices[edge.second].position)
+                     .length();
+  }
+  CHECK_EQ(flipped, 0);
+  CHECK(std::abs(outline - 4.0f * n) < 1e-3f);
+  CHECK(std::abs(area - float(n * n)) < 1e-2f);
+}
+
+void uvSeamStaysInPlace() {
+  const int n = 24;
+  MeshBuffer plane = grid(n, true);
+  MeshBuffer result = simplifyMesh(plane, 3 * 80, 1.0f);
+
+  CHECK(indicesInRange(result));
+  CHECK(result.indices.size() < plane.indices.size() / 4);
+  CHECK_EQ(verticesNotInInput(plane, result), 0);
+
+  // Each triangle stays on one side of the seam, and each side keeps its
+  // exact area, so the seam column did not move.
+  float areas[2] = {0.0f, 0.0f};
+  int mixed = 0;
+  for (size_t i = 0; i < result.indices.size(); i += 3) {
+    bool rightHalf[3];
+    for (int k = 0; k < 3; ++k) {
+      const Vertex &v = result.vertices[result.indices[i + k]];
+      rightHalf[k] = v.uv.x > 1.5f;
+    }
+    if (rightHalf[0] != rightHalf[1] || rightHalf[1] != rightHalf[2]) {
+      ++mixed;
+      continue;
+    }
+    areas[rightHalf[0]] += faceNormal(result, i).z * 0.5f;
+  }
+  CHECK_EQ(mixed, 0);
+  CHECK(std::abs(areas[0] - float(n * n / 2)) < 1e-2f);
+  CHECK(std::abs(areas[1] - float(n * n / 2)) < 1e-2f);
+}
+
+void errorLimitStopsEarly() {
+  // Collapsing a sphere far enough distorts it more than a tight limit
+  // allows, so the result keeps more triangles than requested.
+  MeshBuffer sphere = closedSphere(16, 32);
+  MeshBuffer result = simplifyMesh(sphere, 3 * 8, 0.001f);
+  CHECK(result.indices.size() > 3 * 8);
+  CHECK(result.indices.size() <= sphere.indices.size());
+}
+
+} // namespace
+
+int main() {
+  closedMeshReachesTarget();
+  borderStaysInPlace();
+  uvSeamStaysInPlace();
+  errorLimitStopsEarly();
+  return TEST_RESULT();
+}
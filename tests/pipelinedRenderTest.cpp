@@ -0,0 +1,121 @@
+#include "check.hpp"
+
+#include "farixEngine/assets/texture.hpp"
+#include "farixEngine/renderer/headless/headlessRenderer.hpp"
+
+#include <cstdlib>
+#include <vector>
+
+using namespace farixEngine;
+using namespace farixEngine::renderer;
+
+// A pipelined software renderer must produce the same frame as a synchronous
+// one, and keep textures alive until the render thread is done with them even
+// when the caller drops its last reference right after endFrame().
+
+namespace {
+
+const int kWidth = 64;
+const int kHeight = 48;
+
+std::shared_ptr<farixEngine::Texture> makeChecker() {
+  auto texture = std::make_shared<farixEngine::Texture>();
+  texture->texWidth = 8;
+  texture->texHeight = 8;
+  texture->texturePixels = static_cast<unsigned char *>(std::malloc(8 * 8 * 4));
+  for (int i = 0; i < 8 * 8; ++i) {
+    bool light = ((i % 8) / 2 + (i / 8) / 2) % 2 == 0;
+    unsigned char *p = texture->texturePixels + i * 4;
+    p[0] = light ? 230 : 40;
+    p[1] = light ? 200 : 60;
+    p[2] = light ? 40 : 160;
+    p[3] = 255;
+  }
+  texture->buildMipChain();
+  return texture;
+}
+
+std::shared_ptr<MeshData> makeQuad() {
+  auto buffer = std::make_shared<MeshBuffer>();
+  buffer->vertices = {{Vec3(-1, -1, 0), Vec3(0, 0, 1), Vec2(0, 0)},
+                      {Vec3(1, -1, 0), Vec3(0, 0, 1), Vec2(1, 0)},
+                      {Vec3(1, 1, 0), Vec3(0, 0, 1), Vec2(1, 1)},
+                      {Vec3(-1, 1, 0), Vec3(0, 0, 1), Vec2(0, 1)}};
+  buffer->indices = {0, 1, 2, 0, 2, 3};
+  auto mesh = std::make_shared<MeshData>();
+  mesh->buffer = buffer;
+  return mesh;
+}
+
+void recordFrame(SoftwareRenderer &renderer, RenderContext &ctx,
+                 const std::shared_ptr<MeshData> &quad,
+                 farixEngine::Texture *texture) {
+  MaterialData material;
+  material.useTexture = texture != nullptr;
+  material.texture = texture;
+
+  renderer.beginFrame();
+  renderer.beginPass(ctx);
+  renderer.submitMesh(quad,
+                      Mat4::rotateY(0.5f) * Mat4::rotateX(-0.3f), material);
+  renderer.endPass();
+}
+
+RenderContext makeContext() {
+  RenderContext ctx;
+  ctx.cameraPosition = Vec3(0.0f, 0.0f, 3.0f);
+  ctx.viewMatrix = Mat4::lookAt(ctx.cameraPosition, Vec3(0.0f),
+                                Vec3(0.0f, 1.0f, 0.0f));
+  ctx.projectionMatrix = Mat4::perspective(
+      1.0f, static_cast<float>(kWidth) / kHeight, ctx.nearPlane, ctx.farPlane);
+  return ctx;
+}
+
+} // namespace
+
+int main() {
+  auto quad = makeQuad();
+  RenderContext ctx = makeContext();
+
+  HeadlessRenderer reference(kWidth, kHeight);
+  {
+    auto texture = makeChecker();
+    recordFrame(reference, ctx, quad, texture.get());
+    reference.endFrame();
+  }
+  std::vector<uint32_t> expected = reference.readPixels();
+
+  HeadlessRenderer renderer(kWidth, kHeight);
+  renderer.setPipelined(true);
+  CHECK(renderer.isPipelined());
+
+  std::weak_ptr<farixEngine::Texture> released;
+  {
+    auto texture = makeChecker();
+    released = texture;
+    recordFrame(renderer, ctx, quad, texture.get());
+    renderer.endFrame();
+  }
+  // The only owner left is the frame being rasterized.
+  CHECK(!released.expired());
+
+  renderer.waitForFrame();
+  CHECK_EQ(renderer.getFrameCount(), 1u);
+  CHECK(renderer.readPixels() == expected);
+
+  // A second frame presents the first one late and renders without the
+  // texture; the snapshot that pinned it is gone a frame later.
+  for (int frame = 0; frame < 2; ++frame) {
+    recordFrame(renderer, ctx, quad, nullptr);
+    renderer.endFrame();
+  }
+  renderer.waitForFrame();
+  CHECK_EQ(renderer.getFrameCount(), 3u);
+  recordFrame(renderer, ctx, quad, nullptr);
+  CHECK(released.expired());
+  renderer.endFrame();
+
+  renderer.setPipelined(false);
+  CHECK(!renderer.isPipelined());
+  return TEST_RESULT();
+}
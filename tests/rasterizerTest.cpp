@@ -0,0 +1,228 @@
+#include "check.hpp"
+
+#include "farixEngine/renderer/headless/headlessRenderer.hpp"
+
+#include <cmath>
+#include <vector>
+
+using namespace farixEngine;
+using namespace farixEngine::renderer;
+
+// Coverage tests for the software rasterizer and its clipper. Triangles are
+// drawn additively without a depth test, so every pixel's red channel counts
+// how many triangles covered it.
+
+namespace {
+
+const int kWidth = 96;
+const int kHeight = 64;
+const uint32_t kBlack = 0xFF000000;
+const int kStep = 64;
+
+struct Scene {
+  std::shared_ptr<MeshBuffer> buffer = std::make_shared<MeshBuffer>();
+
+  void vertex(float x, float y, float z = 0.0f) {
+    buffer->vertices.push_back({Vec3(x, y, z), Vec3(0, 0, 1), Vec2(0, 0)});
+  }
+  void triangle(uint32_t a, uint32_t b, uint32_t c) {
+    buffer->indices.insert(buffer->indices.end(), {a, b, c});
+  }
+  std::shared_ptr<MeshData> mesh() const {
+    auto data = std::make_shared<MeshData>();
+    data->buffer = buffer;
+    return data;
+  }
+};
+
+// Pixel-space pass: vertex x/y are framebuffer coordinates.
+RenderContext pixelContext() {
+  RenderContext ctx;
+  ctx.viewMatrix = Mat4::identity();
+  ctx.projectionMatrix = Mat4::ortho(0, kWidth, kHeight, 0, -1, 1);
+  ctx.is2DPass = true;
+  ctx.enableZBuffer = false;
+  ctx.enableLighting = false;
+  return ctx;
+}
+
+// Camera at the origin looking down -z.
+RenderContext perspectiveContext() {
+  RenderContext ctx;
+  ctx.viewMatrix = Mat4::identity();
+  ctx.projectionMatrix = Mat4::perspective(
+      1.2f, static_cast<float>(kWidth) / kHeight, ctx.nearPlane, ctx.farPlane);
+  ctx.enableZBuffer = false;
+  ctx.enableLighting = false;
+  return ctx;
+}
+
+std::vector<int> coverage(const Scene &scene,
+                          RenderContext ctx = pixelContext()) {
+  HeadlessRenderer renderer(kWidth, kHeight);
+
+  MaterialData material;
+  material.baseColor = Vec4(kStep / 255.0f, kStep / 255.0f, kStep / 255.0f, 1);
+  material.blendMode = BlendMode::Additive;
+
+  renderer.beginFrame();
+  renderer.clear(kBlack);
+  renderer.beginPass(ctx);
+  renderer.submitMesh(scene.mesh(), Mat4::identity(), material);
+  renderer.endPass();
+  renderer.endFrame();
+
+  std::vector<int> counts(kWidth * kHeight);
+  for (int y = 0; y < kHeight; ++y) {
+    for (int x = 0; x < kWidth; ++x) {
+      int red = (renderer.readPixel(x, y) >> 16) & 0xFF;
+      counts[y * kWidth + x] = (red + kStep / 2) / kStep;
+    }
+  }
+  return counts;
+}
+
+void sharedDiagonalCoversEachPixelOnce() {
+  Scene scene;
+  scene.vertex(8, 8);
+  scene.vertex(40, 8);
+  scene.vertex(40, 40);
+  scene.vertex(8, 40);
+  scene.triangle(0, 1, 2);
+  scene.triangle(0, 2, 3);
+
+  std::vector<int> counts = coverage(scene);
+  int wrong = 0;
+  for (int y = 0; y < kHeight; ++y) {
+    for (int x = 0; x < kWidth; ++x) {
+      bool inside = x >= 8 && x < 40 && y >= 8 && y < 40;
+      if (counts[y * kWidth + x] != (inside ? 1 : 0))
+        ++wrong;
+    }
+  }
+  CHECK_EQ(wrong, 0);
+}
+
+void adjacentQuadsDoNotOverlap() {
+  // Two quads sharing a vertical and a horizontal edge at pixel boundaries.
+  Scene scene;
+  scene.vertex(4, 4);
+  scene.vertex(20, 4);
+  scene.vertex(36, 4);
+  scene.vertex(4, 20);
+  scene.vertex(20, 20);
+  scene.vertex(36, 20);
+  for (uint32_t base : {0u, 1u}) {
+    scene.triangle(base, base + 1, base + 4);
+    scene.triangle(base, base + 4, base + 3);
+  }
+
+  std::vector<int> counts = coverage(scene);
+  int covered = 0, overlapped = 0;
+  for (int count : counts) {
+    covered += count > 0;
+    overlapped += count > 1;
+  }
+  CHECK_EQ(overlapped, 0);
+  CHECK_EQ(covered, 32 * 16);
+}
+
+void subpixelFanHasNoGapsOrOverlaps() {
+  // A fan around an off-grid centre: every interior edge is shared by two
+  // triangles at arbitrary subpixel positions.
+  const float cx = 47.3f, cy = 31.6f, radius = 24.7f;
+  const int segments = 17;
+  Scene scene;
+  scene.vertex(cx, cy);
+  for (int i = 0; i < segments; ++i) {
+    float angle = 6.2831853f * i / segments + 0.1f;
+    scene.vertex(cx + radius * std::cos(angle), cy + radius * std::sin(angle));
+  }
+  for (int i = 0; i < segments; ++i)
+    scene.triangle(0, 1 + i, 1 + (i + 1) % segments);
+
+  std::vector<int> counts = coverage(scene);
+  // Pixels whose centre is safely inside the polygon's inscribed circle.
+  float inner = radius * std::cos(3.14159265f / segments) - 1.0f;
+  int overlapped = 0, gaps = 0;
+  for (int y = 0; y < kHeight; ++y) {
+    for (int x = 0; x < kWidth; ++x) {
+      int count = counts[y * kWidth + x];
+      overlapped += count > 1;
+      float dx = x + 0.5f - cx, dy = y + 0.5f - cy;
+      if (dx * dx + dy * dy < inner * inner && count != 1)
+        ++gaps;
+    }
+  }
+  CHECK_EQ(overlapped, 0);
+  CHECK_EQ(gaps, 0);
+}
+
+void floorCrossingNearPlaneIsClipped() {
+  // A floor quad below the camera reaching from behind it to the far
+  // distance: only the part in front of the near plane may be drawn.
+  Scene scene;
+  scene.vertex(-100, -1, 5);
+  scene.vertex(100, -1, 5);
+  scene.vertex(100, -1, -50);
+  scene.vertex(-100, -1, -50);
+  scene.triangle(0, 1, 2);
+  scene.triangle(0, 2, 3);
+
+  std::vector<int> counts = coverage(scene, perspectiveContext());
+  int bottomRow = 0, upperHalf = 0, overlapped = 0;
+  for (int y = 0; y < kHeight; ++y) {
+    for (int x = 0; x < kWidth; ++x) {
+      int count = counts[y * kWidth + x];
+      overlapped += count > 1;
+      if (y == kHeight - 1)
+        bottomRow += count;
+      if (y < kHeight / 2)
+        upperHalf += count;
+    }
+  }
+  CHECK_EQ(bottomRow, kWidth);
+  CHECK_EQ(upperHalf, 0);
+  CHECK_EQ(overlapped, 0);
+}
+
+void hugeTriangleFillsTheScreenOnce() {
+  // Vertices far outside the guard band on every side.
+  Scene scene;
+  scene.vertex(-1000, -1000, -2);
+  scene.vertex(3000, -1000, -2);
+  scene.vertex(-1000, 3000, -2);
+  scene.triangle(0, 1, 2);
+
+  std::vector<int> counts = coverage(scene, perspectiveContext());
+  int wrong = 0;
+  for (int count : counts)
+    wrong += count != 1;
+  CHECK_EQ(wrong, 0);
+}
+
+void triangleBehindCameraIsRejected() {
+  Scene scene;
+  scene.vertex(-1, -1, 2);
+  scene.vertex(1, -1, 2);
+  scene.vertex(0, 1, 2);
+  scene.triangle(0, 1, 2);
+
+  std::vector<int> counts = coverage(scene, perspectiveContext());
+  int covered = 0;
+  for (int count : counts)
+    covered += count;
+  CHECK_EQ(covered, 0);
+}
+
+} // namespace
+
+int main() {
+  sharedDiagonalCoversEachPixelOnce();
+  adjacentQuadsDoNotOverlap();
+  subpixelFanHasNoGapsOrOverlaps();
+  floorCrossingNearPlaneIsClipped();
+  hugeTriangleFillsTheScreenOnce();
+  triangleBehindCameraIsRejected();
+  return TEST_RESULT();
+}
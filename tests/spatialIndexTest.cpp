@@ -0,0 +1,77 @@
+#include "check.hpp"
+
+#include "farixEngine/core/spatialIndex.hpp"
+#include "farixEngine/math/mat4.hpp"
+
+#include <algorithm>
+#include <random>
+
+using namespace farixEngine;
+
+namespace {
+
+BoundingSphere sphereAt(const Vec3 &center, float radius) {
+  BoundingSphere sphere;
+  sphere.center = center;
+  sphere.radius = radius;
+  return sphere;
+}
+
+AABB boxAround(const BoundingSphere &sphere) {
+  AABB box;
+  box.min = sphere.center - Vec3(sphere.radius);
+  box.max = sphere.center + Vec3(sphere.radius);
+  return box;
+}
+
+Frustum lookingAt(const Vec3 &eye, const Vec3 &target) {
+  return Frustum::fromMatrix(Mat4::perspective(1.2f, 1.0f, 0.1f, 1000.0f) *
+                             Mat4::lookAt(eye, target, Vec3(0, 1, 0)));
+}
+
+// A cluster far denser than kSplitThreshold splits nodes recursively while
+// their children are being created.
+void denseClusterSplitsAndQueries() {
+  SpatialIndex index;
+  // The first entity sits at the root's center, so the cluster below lands
+  // in a single octant.
+  index.update(1, boxAround(sphereAt(Vec3(0), 0.01f)),
+               sphereAt(Vec3(0), 0.01f));
+
+  std::mt19937 rng(7);
+  std::uniform_real_distribution<float> offset(-0.5f, 0.5f);
+  const uint32_t count = 600;
+  for (uint32_t e = 2; e < count + 2; ++e) {
+    BoundingSphere sphere = sphereAt(
+        Vec3(5 + offset(rng), 5 + offset(rng), 5 + offset(rng)), 0.01f);
+    index.update(e, boxAround(sphere), sphere);
+  }
+  CHECK_EQ(index.size(), size_t(count + 1));
+
+  std::vector<SpatialIndex::Entity> visible;
+  index.query(lookingAt(Vec3(5, 5, 20), Vec3(5, 5, 5)), visible);
+  std::sort(visible.begin(), visible.end());
+  CHECK(std::adjacent_find(visible.begin(), visible.end()) == visible.end());
+  size_t cluster = std::count_if(visible.begin(), visible.end(),
+                                 [](SpatialIndex::Entity e) { return e >= 2; });
+  CHECK_EQ(cluster, size_t(count));
+
+  visible.clear();
+  index.query(lookingAt(Vec3(5, 5, 20), Vec3(5, 5, 40)), visible);
+  CHECK(visible.empty());
+
+  for (uint32_t e = 2; e < count + 2; e += 2)
+    index.remove(e);
+  visible.clear();
+  index.query(lookingAt(Vec3(5, 5, 20), Vec3(5, 5, 5)), visible);
+  cluster = std::count_if(visible.begin(), visible.end(),
+                          [](SpatialIndex::Entity e) { return e >= 2; });
+  CHECK_EQ(cluster, size_t(count / 2));
+}
+
+} // namespace
+
+int main() {
+  denseClusterSplitsAndQueries();
+  return TEST_RESULT();
+}
@@ -0,0 +1,138 @@
+#include "check.hpp"
+
+#include "farixEngine/renderer/spriteBatcher.hpp"
+
+using namespace farixEngine;
+using namespace farixEngine::renderer;
+
+namespace {
+
+// Stand-ins for texture identities; only their addresses matter.
+int textureA;
+int textureB;
+
+const Vec4 white(1.0f, 1.0f, 1.0f, 1.0f);
+
+void add(SpriteBatcher &batcher, uint32_t command, const void *texture,
+         BlendMode blendMode) {
+  batcher.add(command, Mat4::translate(Vec3(float(command), 0, 0)),
+              Vec2(0, 0), Vec2(1, 1), white, texture, blendMode);
+}
+
+bool sameBatch(const SpriteBatch &batch, uint32_t command,
+               const void *texture, BlendMode blendMode, uint32_t firstQuad,
+               uint32_t quadCount) {
+  return batch.command == command && batch.texture == texture &&
+         batch.blendMode == blendMode && batch.firstQuad == firstQuad &&
+         batch.quadCount == quadCount;
+}
+
+bool sameVertex(const SpriteVertex &v, const Vec3 &position, const Vec2 &uv) {
+  return v.position == position && v.uv == uv;
+}
+
+void texturesAndBlendModesBreakBatches() {
+  SpriteBatcher batcher;
+  RecordingSpriteBackend backend;
+  add(batcher, 0, &textureA, BlendMode::Alpha);
+  add(batcher, 1, &textureA, BlendMode::Alpha);
+  add(batcher, 2, &textureB, BlendMode::Alpha);
+  add(batcher, 3, &textureB, BlendMode::Additive);
+  // Returning to an earlier texture starts a new batch: order is kept.
+  add(batcher, 4, &textureA, BlendMode::Alpha);
+  add(batcher, 5, nullptr, BlendMode::Alpha);
+  add(batcher, 6, nullptr, BlendMode::Alpha);
+  batcher.flush(backend);
+
+  CHECK_EQ(backend.uploads.size(), size_t(1));
+  CHECK_EQ(backend.draws.size(), size_t(5));
+  if (backend.uploads.size() != 1 || backend.draws.size() != 5)
+    return;
+  CHECK_EQ(backend.uploads[0].size(), size_t(7 * 4));
+  CHECK(sameBatch(backend.draws[0], 0, &textureA, BlendMode::Alpha, 0, 2));
+  CHECK(sameBatch(backend.draws[1], 2, &textureB, BlendMode::Alpha, 2, 1));
+  CHECK(sameBatch(backend.draws[2], 3, &textureB, BlendMode::Additive, 3, 1));
+  CHECK(sameBatch(backend.draws[3], 4, &textureA, BlendMode::Alpha, 4, 1));
+  CHECK(sameBatch(backend.draws[4], 5, nullptr, BlendMode::Alpha, 5, 2));
+
+  // Quads follow submission order in the stream.
+  for (uint32_t quad = 0; quad < 7; ++quad)
+    CHECK_EQ(backend.uploads[0][quad * 4].position.x, float(quad) - 0.5f);
+}
+
+void cornersTakeTheirUvs() {
+  SpriteBatcher batcher;
+  RecordingSpriteBackend backend;
+  Mat4 model = Mat4::translate(Vec3(10, 20, 3)) * Mat4::scale(Vec3(2, 4, 1));
+  Vec4 color(0.25f, 0.5f, 0.75f, 0.5f);
+  batcher.add(0, model, Vec2(0.25f, 0.5f), Vec2(0.75f, 1.0f), color,
+              &textureA, BlendMode::Alpha);
+  batcher.flush(backend);
+
+  CHECK_EQ(backend.uploads.size(), size_t(1));
+  if (backend.uploads.size() != 1)
+    return;
+  CHECK_EQ(backend.uploads[0].size(), size_t(4));
+  if (backend.uploads[0].size() != 4)
+    return;
+  const std::vector<SpriteVertex> &v = backend.uploads[0];
+  CHECK(sameVertex(v[0], Vec3(9, 18, 3), Vec2(0.25f, 0.5f)));
+  CHECK(sameVertex(v[1], Vec3(11, 18, 3), Vec2(0.75f, 0.5f)));
+  CHECK(sameVertex(v[2], Vec3(11, 22, 3), Vec2(0.75f, 1.0f)));
+  CHECK(sameVertex(v[3], Vec3(9, 22, 3), Vec2(0.25f, 1.0f)));
+  for (const SpriteVertex &vertex : v)
+    CHECK(vertex.color == color);
+}
+
+void flippedSprites() {
+  SpriteBatcher batcher;
+  RecordingSpriteBackend backend;
+  // flipX swaps the U range before the sprite reaches the batcher.
+  batcher.add(0, Mat4::identity(), Vec2(1, 0), Vec2(0, 1), white, &textureA,
+              BlendMode::Alpha);
+  // A mirroring model matrix moves the uvMin corner to the other side.
+  batcher.add(1, Mat4::scale(Vec3(-1, 1, 1)), Vec2(0, 0), Vec2(1, 1), white,
+              &textureA, BlendMode::Alpha);
+  batcher.flush(backend);
+
+  CHECK_EQ(backend.draws.size(), size_t(1));
+  CHECK_EQ(backend.uploads.size(), size_t(1));
+  if (backend.uploads.size() != 1)
+    return;
+  CHECK_EQ(backend.uploads[0].size(), size_t(8));
+  if (backend.uploads[0].size() != 8)
+    return;
+  const std::vector<SpriteVertex> &v = backend.uploads[0];
+  CHECK(sameVertex(v[0], Vec3(-0.5f, -0.5f, 0), Vec2(1, 0)));
+  CHECK(sameVertex(v[1], Vec3(0.5f, -0.5f, 0), Vec2(0, 0)));
+  CHECK(sameVertex(v[2], Vec3(0.5f, 0.5f, 0), Vec2(0, 1)));
+  CHECK(sameVertex(v[3], Vec3(-0.5f, 0.5f, 0), Vec2(1, 1)));
+
+  CHECK(sameVertex(v[4], Vec3(0.5f, -0.5f, 0), Vec2(0, 0)));
+  CHECK(sameVertex(v[5], Vec3(-0.5f, -0.5f, 0), Vec2(1, 0)));
+  CHECK(sameVertex(v[6], Vec3(-0.5f, 0.5f, 0), Vec2(1, 1)));
+  CHECK(sameVertex(v[7], Vec3(0.5f, 0.5f, 0), Vec2(0, 1)));
+}
+
+void emptyFlushUploadsNothing() {
+  SpriteBatcher batcher;
+  RecordingSpriteBackend backend;
+  batcher.flush(backend);
+  CHECK(backend.uploads.empty());
+  CHECK(backend.draws.empty());
+
+  add(batcher, 0, &textureA, BlendMode::Alpha);
+  batcher.flush(backend);
+  CHECK_EQ(batcher.quadCount(), size_t(0));
+  CHECK_EQ(batcher.batchCount(), size_t(0));
+}
+
+} // namespace
+
+int main() {
+  texturesAndBlendModesBreakBatches();
+  cornersTakeTheirUvs();
+  flippedSprites();
+  emptyFlushUploadsNothing();
+  return TEST_RESULT();
+}
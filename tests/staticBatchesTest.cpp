@@ -0,0 +1,197 @@
+#include "check.hpp"
+
+#include "farixEngine/assets/material.hpp"
+#include "farixEngine/assets/mesh.hpp"
+#include "farixEngine/core/engineServices.hpp"
+#include "farixEngine/core/world.hpp"
+#include "farixEngine/renderer/renderData.hpp"
+#include "farixEngine/systems/systems.hpp"
+
+#include <string>
+#include <vector>
+
+using namespace farixEngine;
+
+namespace {
+
+using Entity = World::Entity;
+
+void addAssets() {
+  auto &am = EngineServices::get().getAssetManager();
+  am.add(Mesh::createBox(1.0f, 1.0f, 1.0f, "box"));
+
+  // Two disjoint triangles per 6 vertices, 30000 vertices in all.
+  std::vector<Vertex> vertices(30000);
+  std::vector<uint32_t> indices;
+  for (uint32_t i = 0; i < vertices.size(); ++i) {
+    vertices[i].position = Vec3(float(i % 3), float(i % 2), 0.0f) * 0.25f;
+    vertices[i].normal = Vec3(0, 0, 1);
+    indices.push_back(i);
+  }
+  auto dense = std::make_shared<Mesh>();
+  dense->id = "dense";
+  dense->setGeometry(std::move(vertices), std::move(indices));
+  am.add(dense);
+
+  auto opaque = std::make_shared<Material>("opaque");
+  opaque->blendMode = BlendMode::Opaque;
+  am.add(opaque);
+  auto glass = std::make_shared<Material>("glass");
+  glass->baseColor = Vec4(1.0f, 1.0f, 1.0f, 0.5f);
+  am.add(glass);
+}
+
+Entity spawn(World &world, Vec3 position, const AssetID &mesh = "box",
+             const AssetID &material = "opaque") {
+  Entity e = world.createEntity();
+  TransformComponent transform;
+  transform.position = position;
+  world.addComponent(e, transform);
+  world.addComponent(e, GlobalTransform{});
+  world.addComponent(e, MeshComponent{mesh});
+  world.addComponent(e, MaterialComponent(material));
+  return e;
+}
+
+void step(World &world, int frames = 1) {
+  HierarchySystem hierarchy;
+  for (int i = 0; i < frames; ++i)
+    hierarchy.onUpdate(world, 0.016f);
+}
+
+void selectsOnlyStaticOpaqueMeshes() {
+  World world;
+  for (int i = 0; i < 3; ++i)
+    spawn(world, Vec3(float(i), 0, 0));
+
+  // Pairs that would merge if they were static and opaque.
+  for (int i = 0; i < 2; ++i) {
+    Entity body = spawn(world, Vec3(float(i), 2, 0));
+    world.addComponent(body, RigidBodyComponent{});
+
+    Entity overridden = spawn(world, Vec3(float(i), 4, 0));
+    world.getComponent<MaterialComponent>(overridden).overrides.baseColor =
+        Vec4(1, 0, 0, 1);
+
+    spawn(world, Vec3(float(i), 6, 0), "box", "glass");
+
+    Entity billboard = world.createEntity();
+    world.addComponent(billboard, TransformComponent{});
+    world.addComponent(billboard, GlobalTransform{});
+    world.addComponent(billboard, BillboardComponent{});
+    world.setParent(spawn(world, Vec3(float(i), 8, 0)), billboard);
+  }
+
+  world.buildStaticBatches();
+  StaticBatches &batches = world.getStaticBatches();
+  CHECK_EQ(batches.batchCount(), size_t(1));
+  CHECK_EQ(batches.memberCount(), size_t(3));
+  for (Entity e = 1; e <= 3; ++e)
+    CHECK(batches.isBatched(e));
+
+  const StaticBatches::Batch &batch = batches.batch(0);
+  CHECK_EQ(batch.material, AssetID("opaque"));
+  CHECK_EQ(batch.mesh->vertices().size(), size_t(3 * 24));
+  CHECK_EQ(batch.mesh->indices().size(), size_t(3 * 36));
+  // Vertices are in world space.
+  CHECK(batch.bounds.min.x <= -0.5f && batch.bounds.max.x >= 2.5f);
+}
+
+void splitsByCellAndVertexCount() {
+  World world;
+  // Two cells of two boxes, and a lone box that stays unbatched.
+  spawn(world, Vec3(1, 0, 0));
+  spawn(world, Vec3(2, 0, 0));
+  spawn(world, Vec3(101, 0, 0));
+  spawn(world, Vec3(102, 0, 0));
+  Entity lone = spawn(world, Vec3(-101, 0, 0));
+  // Four 30000-vertex meshes: two per batch under the 16-bit index limit.
+  for (int i = 0; i < 4; ++i)
+    spawn(world, Vec3(float(i), 0, 200), "dense");
+
+  world.buildStaticBatches(32.0f);
+  StaticBatches &batches = world.getStaticBatches();
+  CHECK_EQ(batches.batchCount(), size_t(4));
+  CHECK(!batches.isBatched(lone));
+
+  int denseBatches = 0;
+  for (size_t i = 0; i < batches.batchCount(); ++i) {
+    const StaticBatches::Batch &batch = batches.batch(uint32_t(i));
+    CHECK_EQ(batch.members.size(), size_t(2));
+    CHECK(batch.mesh->vertices().size() <= StaticBatches::kMaxBatchVertices);
+    denseBatches += batch.mesh->vertices().size() == 60000;
+  }
+  CHECK_EQ(denseBatches, 2);
+}
+
+void movedEntityDissolvesAndRejoins() {
+  World world;
+  Entity a = spawn(world, Vec3(0, 0, 0));
+  Entity b = spawn(world, Vec3(1, 0, 0));
+  Entity c = spawn(world, Vec3(2, 0, 0));
+  world.buildStaticBatches();
+  StaticBatches &batches = world.getStaticBatches();
+  batches.takeRetiredMeshes();
+  const std::string original = batches.batch(0).mesh->uuid;
+
+  // Unchanged transforms keep the batch.
+  step(world, 2);
+  CHECK_EQ(batches.batchCount(), size_t(1));
+  CHECK_EQ(batches.batch(0).mesh->uuid, original);
+  CHECK(world.getSpatialIndex().size() == 0);
+
+  world.getComponent<TransformComponent>(c).position = Vec3(3, 0, 0);
+  step(world);
+  // The rest of the cell merged again at the end of the same update.
+  CHECK_EQ(batches.batchCount(), size_t(1));
+  CHECK(batches.isBatched(a) && batches.isBatched(b));
+  CHECK(!batches.isBatched(c));
+  CHECK(batches.isSettling(c));
+  CHECK(batches.batch(0).mesh->uuid != original);
+  CHECK(batches.takeRetiredMeshes() == std::vector<std::string>{original});
+
+  // Still moving: the settle count restarts.
+  step(world, 10);
+  world.getComponent<TransformComponent>(c).position = Vec3(2.5f, 0, 0);
+  step(world, StaticBatches::kSettleFrames);
+  CHECK(!batches.isBatched(c));
+  step(world);
+  CHECK(batches.isBatched(c));
+  CHECK(!batches.isSettling(c));
+  CHECK_EQ(batches.batchCount(), size_t(1));
+  CHECK_EQ(batches.memberCount(), size_t(3));
+  CHECK_EQ(batches.takeRetiredMeshes().size(), size_t(1));
+  CHECK(world.getSpatialIndex().size() == 0);
+}
+
+void destroyedMemberDissolvesItsBatch() {
+  World world;
+  spawn(world, Vec3(0, 0, 0));
+  Entity b = spawn(world, Vec3(1, 0, 0));
+  spawn(world, Vec3(2, 0, 0));
+  world.buildStaticBatches();
+  StaticBatches &batches = world.getStaticBatches();
+
+  world.destroyEntity(b);
+  step(world);
+  CHECK_EQ(batches.batchCount(), size_t(1));
+  CHECK_EQ(batches.memberCount(), size_t(2));
+  CHECK(!batches.isSettling(b));
+
+  // Clearing the world hands back the remaining batch's mesh too.
+  batches.takeRetiredMeshes();
+  world.clearStorages();
+  CHECK_EQ(batches.batchCount(), size_t(0));
+  CHECK_EQ(batches.takeRetiredMeshes().size(), size_t(1));
+}
+
+} // namespace
+
+int main() {
+  addAssets();
+  selectsOnlyStaticOpaqueMeshes();
+  splitsByCellAndVertexCount();
+  movedEntityDissolvesAndRejoins();
+  destroyedMemberDissolvesItsBatch();
+  return TEST_RESULT();
+}